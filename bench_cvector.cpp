@@ -0,0 +1,318 @@
+#include <benchmark/benchmark.h>
+#include <boost/circular_buffer.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <deque>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+import cvector;
+
+using namespace containers;
+
+// Google Benchmark suite: cvector against std::vector, std::deque and boost::circular_buffer
+// element types: int (4 bytes), a 64 byte trivially copyable payload, and std::string (short, in the small string buffer)
+// run with --benchmark_format=json (or --benchmark_out=file.json) for output that can be diffed between builds
+
+constexpr int64_t elements = 1 << 16;
+
+struct payload64 {
+    std::array<uint64_t, 8> words;
+};
+
+template <typename T>
+T make(size_t i) {
+    if constexpr (std::is_same_v<T, payload64>) {
+        return payload64{{i}};
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        return std::string(8, static_cast<char>('a' + i % 26));
+    } else {
+        return static_cast<T>(i);
+    }
+}
+
+template <typename T>
+size_t value_of(const T& value) {
+    if constexpr (std::is_same_v<T, payload64>) {
+        return value.words[0];
+    } else if constexpr (std::is_same_v<T, std::string>) {
+        return static_cast<size_t>(value[0]);
+    } else {
+        return static_cast<size_t>(value);
+    }
+}
+
+// boost::circular_buffer has a fixed capacity, so double it when full, the way it is used as an unbounded queue
+template <typename T>
+class growing_circular_buffer {
+    private:
+        boost::circular_buffer<T> data_;
+
+        void make_room() {
+            if (data_.full()) {
+                data_.set_capacity(data_.capacity() ? data_.capacity() * 2 : 1);
+            }
+        }
+
+    public:
+        using value_type = T;
+
+        void push_back(const T& value) {
+            make_room();
+            data_.push_back(value);
+        }
+        void push_front(const T& value) {
+            make_room();
+            data_.push_front(value);
+        }
+        void pop_back() {
+            data_.pop_back();
+        }
+        void pop_front() {
+            data_.pop_front();
+        }
+        const T& front() const {
+            return data_.front();
+        }
+        const T& back() const {
+            return data_.back();
+        }
+        const T& operator[](size_t index) const {
+            return data_[index];
+        }
+        size_t size() const {
+            return data_.size();
+        }
+        auto begin() const {
+            return data_.begin();
+        }
+        auto end() const {
+            return data_.end();
+        }
+};
+
+template <typename Container>
+concept double_ended = requires(Container& c, const typename Container::value_type& value) {
+    c.push_front(value);
+    c.pop_front();
+};
+
+template <typename Container>
+Container filled(int64_t n) {
+    using T = typename Container::value_type;
+    Container c;
+    for (int64_t i = 0; i < n; ++i) {
+        c.push_back(make<T>(static_cast<size_t>(i)));
+    }
+    return c;
+}
+
+// growth: fill an empty container, including every reallocation
+template <typename Container>
+void push_back_growth(benchmark::State& state) {
+    using T = typename Container::value_type;
+    for (auto _ : state) {
+        Container c;
+        for (int64_t i = 0; i < state.range(0); ++i) {
+            c.push_back(make<T>(static_cast<size_t>(i)));
+        }
+        benchmark::DoNotOptimize(c);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Container>
+void push_pop_back(benchmark::State& state) {
+    using T = typename Container::value_type;
+    Container c = filled<Container>(state.range(0));
+    T value = make<T>(1);
+    for (auto _ : state) {
+        c.push_back(value);
+        benchmark::DoNotOptimize(c.back());
+        c.pop_back();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <typename Container>
+void push_pop_front(benchmark::State& state) {
+    using T = typename Container::value_type;
+    Container c = filled<Container>(state.range(0));
+    T value = make<T>(1);
+    for (auto _ : state) {
+        c.push_front(value);
+        benchmark::DoNotOptimize(c.front());
+        c.pop_front();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// queue with a steady backlog: the ring keeps wrapping around
+template <typename Container>
+void fifo_churn(benchmark::State& state) {
+    using T = typename Container::value_type;
+    Container c = filled<Container>(state.range(0));
+    size_t i = 0;
+    for (auto _ : state) {
+        c.push_back(make<T>(i++));
+        benchmark::DoNotOptimize(value_of(c.front()));
+        c.pop_front();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+template <typename Container>
+void random_access(benchmark::State& state) {
+    Container c = filled<Container>(state.range(0));
+    std::vector<size_t> indices(static_cast<size_t>(state.range(0)));
+    std::mt19937_64 rng(42);
+    for (auto& index : indices) {
+        index = rng() % indices.size();
+    }
+    for (auto _ : state) {
+        size_t sum = 0;
+        for (size_t index : indices) {
+            sum += value_of(c[index]);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename Container>
+void iterate(benchmark::State& state) {
+    Container c = filled<Container>(state.range(0));
+    for (auto _ : state) {
+        size_t sum = 0;
+        for (const auto& value : c) {
+            sum += value_of(value);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// per-tick statistics over a wrapped 4096 element window: sum, min, max and a dot product with fixed weights
+constexpr int64_t window = 4096;
+
+cvector<float> wrapped_window() {
+    cvector<float> ring = filled<cvector<float>>(window);
+    for (int64_t i = 0; i < window / 3; ++i) {
+        ring.pop_front();
+        ring.push_back(make<float>(static_cast<size_t>(i)));
+    }
+    return ring;
+}
+
+// the same statistics with the segmented std-style algorithms, as the compiler vectorizes them on its own
+void window_stats_std(benchmark::State& state) {
+    cvector<float> ring = wrapped_window();
+    std::vector<float> weights(static_cast<size_t>(window), 0.5f);
+    for (auto _ : state) {
+        float sum = containers::accumulate(ring.begin(), ring.end(), 0.0f);
+        float low = containers::accumulate(ring.begin(), ring.end(), ring.front(), [](float a, float b) { return std::min(a, b); });
+        float high = containers::accumulate(ring.begin(), ring.end(), ring.front(), [](float a, float b) { return std::max(a, b); });
+        float dot = std::inner_product(ring.begin(), ring.end(), weights.begin(), 0.0f);
+        benchmark::DoNotOptimize(sum + low + high + dot);
+    }
+    state.SetItemsProcessed(state.iterations() * window);
+}
+
+// state.range(0) is the cvector_simd::isa to run
+void window_stats_simd(benchmark::State& state) {
+    auto level = static_cast<cvector_simd::isa>(state.range(0));
+    if (cvector_simd::use(level) != level) {
+        state.SkipWithError("instruction set not supported by this CPU");
+        return;
+    }
+    cvector<float> ring = wrapped_window();
+    std::vector<float> weights(static_cast<size_t>(window), 0.5f);
+    for (auto _ : state) {
+        float sum = cvector_simd::sum(ring.begin(), ring.end());
+        float low = cvector_simd::min(ring.begin(), ring.end());
+        float high = cvector_simd::max(ring.begin(), ring.end());
+        float dot = cvector_simd::dot(ring.begin(), ring.end(), weights.data());
+        benchmark::DoNotOptimize(sum + low + high + dot);
+    }
+    state.SetItemsProcessed(state.iterations() * window);
+    cvector_simd::use(cvector_simd::detect());
+}
+
+// one tick of a sliding window: a new sample replaces the oldest, then sum, min and max are read
+void window_tick_recompute(benchmark::State& state) {
+    cvector<float> ring = wrapped_window();
+    size_t i = 0;
+    for (auto _ : state) {
+        ring.pop_front();
+        ring.push_back(make<float>(i++ % 1000));
+        float sum = cvector_simd::sum(ring.begin(), ring.end());
+        float low = cvector_simd::min(ring.begin(), ring.end());
+        float high = cvector_simd::max(ring.begin(), ring.end());
+        benchmark::DoNotOptimize(sum + low + high);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+void window_tick_incremental(benchmark::State& state) {
+    windowed_cvector<float> ring(static_cast<size_t>(window));
+    for (int64_t i = 0; i < window; ++i) {
+        ring.push_back(make<float>(static_cast<size_t>(i)));
+    }
+    size_t i = 0;
+    for (auto _ : state) {
+        ring.push_back(make<float>(i++ % 1000));
+        const auto& stats = ring.aggregates();
+        benchmark::DoNotOptimize(stats.sum() + stats.min() + stats.max());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// benchmarks are named workload<container, element>/size, so runs can be compared by name
+template <typename Container>
+void register_container(const std::string& container, const std::string& element) {
+    auto add = [&](const char* workload, void (*bench)(benchmark::State&)) {
+        std::string name = std::string(workload) + "<" + container + ", " + element + ">";
+        benchmark::RegisterBenchmark(name.c_str(), bench)->Arg(elements);
+    };
+    add("PushBackGrowth", push_back_growth<Container>);
+    add("PushPopBack", push_pop_back<Container>);
+    if constexpr (double_ended<Container>) {
+        add("PushPopFront", push_pop_front<Container>);
+        add("FifoChurn", fifo_churn<Container>);
+    }
+    add("RandomAccess", random_access<Container>);
+    add("Iterate", iterate<Container>);
+}
+
+template <typename T>
+void register_element(const std::string& element) {
+    register_container<cvector<T>>("cvector", element);
+    register_container<std::vector<T>>("std::vector", element);
+    register_container<std::deque<T>>("std::deque", element);
+    register_container<growing_circular_buffer<T>>("boost::circular_buffer", element);
+}
+
+int main(int argc, char** argv) {
+    register_element<int>("int");
+    register_element<payload64>("payload64");
+    register_element<std::string>("std::string");
+
+    benchmark::RegisterBenchmark("WindowStats<std>", window_stats_std);
+    const char* isa_names[] = {"scalar", "sse2", "avx2", "avx512"};
+    for (int level = 0; level < 4; ++level) {
+        std::string name = std::string("WindowStats<cvector_simd, ") + isa_names[level] + ">";
+        benchmark::RegisterBenchmark(name.c_str(), window_stats_simd)->Arg(level);
+    }
+    benchmark::RegisterBenchmark("WindowTick<cvector_simd recompute>", window_tick_recompute);
+    benchmark::RegisterBenchmark("WindowTick<windowed_cvector>", window_tick_incremental);
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
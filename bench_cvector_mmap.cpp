@@ -0,0 +1,66 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <bit>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+import cvector;
+
+using namespace containers;
+
+// Large-ring benchmark: malloc-backed cvector against mmap-backed cvectors with and without huge pages
+// measures the time to fill the ring with push_back (including every growth step)
+// and the latency of dependent random operator[] reads, where TLB misses dominate
+// usage: cvector_mmap_bench [megabytes], default 1024
+
+constexpr size_t random_reads = 1 << 24;
+
+// keeps the compiler from discarding the measured work
+volatile uint64_t sink;
+
+uint64_t mix(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return x;
+}
+
+template <typename Vector>
+void run(const char* name, size_t elements) {
+    Vector ring;
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < elements; ++i) {
+        ring.push_back(mix(i));
+    }
+    std::chrono::duration<double> fill = std::chrono::steady_clock::now() - begin;
+
+    // each index depends on the value just read, so reads cannot overlap
+    // mixing in the loop counter keeps the walk from settling into a short, cache-resident cycle
+    size_t mask = std::bit_floor(elements) - 1;
+    uint64_t index = 0;
+    begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < random_reads; ++i) {
+        index = (ring[index] + i) & mask;
+    }
+    std::chrono::duration<double> reads = std::chrono::steady_clock::now() - begin;
+    sink = index;
+
+    std::cout << std::setw(28) << name << std::fixed << std::setprecision(2)
+              << std::setw(12) << fill.count() << std::setw(16) << reads.count() * 1e9 / random_reads << std::endl;
+}
+
+int main(int argc, char** argv) {
+    size_t megabytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1024;
+    size_t elements = (megabytes << 20) / sizeof(uint64_t);
+
+    std::cout << elements << " elements of uint64_t (" << megabytes << " MiB), " << random_reads << " dependent random reads\n";
+    std::cout << std::setw(28) << "storage" << std::setw(12) << "fill (s)" << std::setw(16) << "read (ns)" << std::endl;
+
+    run<cvector<uint64_t>>("malloc", elements);
+    run<cvector<uint64_t, mmap_allocator<uint64_t>>>("mmap", elements);
+    run<cvector<uint64_t, mmap_allocator<uint64_t, huge_pages::transparent>>>("mmap + MADV_HUGEPAGE", elements);
+    run<cvector<uint64_t, mmap_allocator<uint64_t, huge_pages::reserved>>>("mmap + MAP_HUGETLB", elements);
+
+    return 0;
+}
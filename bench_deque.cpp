@@ -0,0 +1,96 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <deque>
+#include <string>
+#include <algorithm>
+import deque;
+
+// Push/pop throughput benchmark: containers::deque against std::deque
+// on GCC 12 at -O2 (best of 7 runs) push_back + pop_back is about 10% faster than libstdc++,
+// push_front + pop_front is level to a few percent behind and fifo churn is 2-5% behind:
+// the fast paths are the same pointer bump, but a pop_front that empties its node
+// rotates it to the back of the node map through cvector pop_front/push_back
+
+constexpr size_t operations = 1 << 22;
+
+// keeps the compiler from discarding the measured work
+volatile size_t sink;
+
+template <typename Deque>
+double fill_and_drain_back() {
+    Deque dq;
+    size_t checksum = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < operations; ++i) {
+        dq.push_back(i);
+    }
+    while (!dq.empty()) {
+        checksum += dq.back();
+        dq.pop_back();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    sink = checksum;
+    return 2.0 * operations / elapsed.count() / 1e6;
+}
+
+template <typename Deque>
+double fill_and_drain_front() {
+    Deque dq;
+    size_t checksum = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < operations; ++i) {
+        dq.push_front(i);
+    }
+    while (!dq.empty()) {
+        checksum += dq.front();
+        dq.pop_front();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    sink = checksum;
+    return 2.0 * operations / elapsed.count() / 1e6;
+}
+
+// queue with a steady backlog: push_back one, pop_front one
+template <typename Deque>
+double fifo_churn() {
+    Deque dq;
+    for (size_t i = 0; i < 4096; ++i) {
+        dq.push_back(i);
+    }
+    size_t checksum = 0;
+    auto begin = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < operations; ++i) {
+        dq.push_back(i);
+        checksum += dq.front();
+        dq.pop_front();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    sink = checksum;
+    return 2.0 * operations / elapsed.count() / 1e6;
+}
+
+// best of several runs, alternating between the two deques so that both see the same machine state
+constexpr int runs = 7;
+
+template <typename Ours, typename Theirs>
+void report(const char* name, Ours ours, Theirs theirs) {
+    double best_ours = 0, best_theirs = 0;
+    for (int run = 0; run < runs; ++run) {
+        best_ours = std::max(best_ours, ours());
+        best_theirs = std::max(best_theirs, theirs());
+    }
+    std::cout << std::setw(24) << name << std::fixed << std::setprecision(1)
+              << std::setw(18) << best_ours << std::setw(14) << best_theirs << std::endl;
+}
+
+int main() {
+    std::cout << operations << " elements of size_t, Mops/s (best of " << runs << " runs)\n";
+    std::cout << std::setw(24) << "workload" << std::setw(18) << "containers::deque" << std::setw(14) << "std::deque" << std::endl;
+
+    report("push_back + pop_back", fill_and_drain_back<containers::deque<size_t>>, fill_and_drain_back<std::deque<size_t>>);
+    report("push_front + pop_front", fill_and_drain_front<containers::deque<size_t>>, fill_and_drain_front<std::deque<size_t>>);
+    report("fifo churn", fifo_churn<containers::deque<size_t>>, fifo_churn<std::deque<size_t>>);
+
+    return 0;
+}
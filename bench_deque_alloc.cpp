@@ -0,0 +1,144 @@
+#include <iostream>
+#include <iomanip>
+#include <deque>
+#include <cstdlib>
+#include <cerrno>
+import deque;
+
+// Allocation-counting benchmark: heap allocations made while a deque churns
+// kept apart from bench_deque.cpp since replacing the allocator changes the code generated for both deques
+
+static size_t allocation_count = 0;
+
+// the malloc family is replaced rather than operator new, so the node map of containers::deque
+// (a cvector on malloc_allocator) is counted along with the nodes and the blocks of std::deque
+// operator new calls malloc, each allocation is counted once; the replacements forward to glibc's allocator
+extern "C" {
+void* __libc_malloc(size_t n);
+void* __libc_calloc(size_t count, size_t n);
+void* __libc_realloc(void* p, size_t n);
+void* __libc_memalign(size_t alignment, size_t n);
+void __libc_free(void* p);
+
+void* malloc(size_t n) noexcept {
+    ++allocation_count;
+    return __libc_malloc(n);
+}
+
+void* calloc(size_t count, size_t n) noexcept {
+    ++allocation_count;
+    return __libc_calloc(count, n);
+}
+
+// a realloc may move the block, so it counts as an allocation
+void* realloc(void* p, size_t n) noexcept {
+    ++allocation_count;
+    return __libc_realloc(p, n);
+}
+
+void* memalign(size_t alignment, size_t n) noexcept {
+    ++allocation_count;
+    return __libc_memalign(alignment, n);
+}
+
+void* aligned_alloc(size_t alignment, size_t n) noexcept {
+    ++allocation_count;
+    return __libc_memalign(alignment, n);
+}
+
+int posix_memalign(void** out, size_t alignment, size_t n) noexcept {
+    ++allocation_count;
+    void* p = __libc_memalign(alignment, n);
+    if (!p) {
+        return ENOMEM;
+    }
+    *out = p;
+    return 0;
+}
+
+void free(void* p) noexcept {
+    __libc_free(p);
+}
+}
+
+// keeps the compiler from discarding the measured work
+volatile size_t sink;
+
+constexpr size_t burst = 16384;
+constexpr size_t rounds = 64;
+
+// the size oscillates between 0 and burst, unused memory is handed back after every burst
+// returns heap allocations per push/pop pair, measured after one warm-up burst
+template <typename Deque>
+double oscillate(Deque& dq) {
+    size_t allocations = 0;
+    size_t checksum = 0;
+    for (size_t round = 0; round <= rounds; ++round) {
+        size_t before = allocation_count;
+        for (size_t i = 0; i < burst; ++i) {
+            dq.push_back(i);
+        }
+        while (!dq.empty()) {
+            checksum += dq.front();
+            dq.pop_front();
+        }
+        dq.shrink_to_fit();
+        if (round > 0) {
+            allocations += allocation_count - before;
+        }
+    }
+    sink = checksum;
+    return static_cast<double>(allocations) / (burst * rounds);
+}
+
+// queue with a steady backlog: push_back one, pop_front one
+template <typename Deque>
+double fifo_churn(Deque& dq) {
+    for (size_t i = 0; i < burst; ++i) {
+        dq.push_back(i);
+    }
+    size_t checksum = 0;
+    size_t before = allocation_count;
+    for (size_t i = 0; i < burst * rounds; ++i) {
+        dq.push_back(i);
+        checksum += dq.front();
+        dq.pop_front();
+    }
+    sink = checksum;
+    return static_cast<double>(allocation_count - before) / (burst * rounds);
+}
+
+void report(const char* name, double oscillating, double churn) {
+    std::cout << std::setw(38) << name << std::fixed << std::setprecision(4)
+              << std::setw(14) << oscillating << std::setw(14) << churn << std::endl;
+}
+
+int main() {
+    std::cout << "Heap allocations per push/pop pair (size_t elements)\n";
+    std::cout << "oscillate: size 0 -> " << burst << " -> 0, shrink_to_fit after every burst\n";
+    std::cout << "fifo churn: push_back + pop_front with a backlog of " << burst << "\n";
+    std::cout << std::setw(38) << "deque" << std::setw(14) << "oscillate" << std::setw(14) << "fifo churn" << std::endl;
+
+    {
+        std::deque<size_t> a, b;
+        report("std::deque", oscillate(a), fifo_churn(b));
+    }
+    {
+        containers::deque<size_t> a, b;
+        report("containers::deque (default pool)", oscillate(a), fifo_churn(b));
+    }
+    {
+        containers::deque<size_t> a, b;
+        a.pool().set_max_free(1024);
+        b.pool().set_max_free(1024);
+        report("containers::deque (high-water 1024)", oscillate(a), fifo_churn(b));
+    }
+    {
+        auto& shared = containers::deque<size_t>::pool_type::thread_local_pool();
+        shared.set_max_free(1024);
+        containers::deque<size_t> a(shared), b(shared);
+        report("containers::deque (thread-local pool)", oscillate(a), fifo_churn(b));
+    }
+
+    return 0;
+}
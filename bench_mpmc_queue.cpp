@@ -0,0 +1,109 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <vector>
+#include <atomic>
+import cvector;
+
+using namespace containers;
+
+// Contention benchmark: mpmc_queue against a mutex-wrapped cvector with the same bound
+// for each thread count N, N producers and N consumers move a fixed total number of items
+
+constexpr size_t queue_capacity = 1024;
+constexpr size_t total_items = 1 << 21;
+
+// bounded queue baseline: cvector guarded by a single mutex
+class locked_cvector {
+    private:
+        std::mutex mutex_;
+        cvector<size_t> data_;
+
+    public:
+        locked_cvector() {
+            data_.reserve(queue_capacity);
+        }
+
+        bool try_push(size_t value) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (data_.size() >= queue_capacity) {
+                return false;
+            }
+            data_.push_back(value);
+            return true;
+        }
+
+        bool try_pop(size_t& out) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (data_.empty()) {
+                return false;
+            }
+            out = data_.front();
+            data_.pop_front();
+            return true;
+        }
+};
+
+// returns millions of items per second, checks that every item arrived exactly once
+template <typename Queue>
+double run(Queue& queue, size_t threads) {
+    size_t per_thread = total_items / threads;
+    std::atomic<bool> start{false};
+    std::atomic<size_t> checksum{0};
+    std::vector<std::thread> workers;
+
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            while (!start.load(std::memory_order_acquire)) {}
+            for (size_t i = 0; i < per_thread; ++i) {
+                while (!queue.try_push(t * per_thread + i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+        workers.emplace_back([&]() {
+            while (!start.load(std::memory_order_acquire)) {}
+            size_t local = 0;
+            size_t value;
+            for (size_t i = 0; i < per_thread; ++i) {
+                while (!queue.try_pop(value)) {
+                    std::this_thread::yield();
+                }
+                local += value;
+            }
+            checksum.fetch_add(local, std::memory_order_relaxed);
+        });
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+    size_t items = per_thread * threads;
+    if (checksum.load() != items * (items - 1) / 2) {
+        std::cout << "checksum mismatch" << std::endl;
+    }
+    return static_cast<double>(items) / elapsed.count() / 1e6;
+}
+
+int main() {
+    std::cout << "Bounded queue contention, capacity " << queue_capacity << ", " << total_items << " items\n";
+    std::cout << std::setw(10) << "threads" << std::setw(16) << "mpmc_queue" << std::setw(16) << "mutex+cvector"
+              << "   (Mitems/s, N producers + N consumers)" << std::endl;
+
+    for (size_t threads = 1; threads <= 64; threads *= 2) {
+        mpmc_queue<size_t> lock_free(queue_capacity);
+        locked_cvector locked;
+        double lock_free_rate = run(lock_free, threads);
+        double locked_rate = run(locked, threads);
+        std::cout << std::setw(10) << threads << std::fixed << std::setprecision(2)
+                  << std::setw(16) << lock_free_rate << std::setw(16) << locked_rate << std::endl;
+    }
+
+    return 0;
+}
@@ -53,7 +53,7 @@ CXXFLAGS="-std=c++23 -fmodules-ts -O2 -Wall -Wextra"
 
 # Clean previous builds
 echo "Cleaning previous builds..."
-rm -f *.gcm *.o cvector_test
+rm -f *.gcm *.o cvector_test deque_test
 rm -rf gcm.cache
 
 # Step 1: Build the standard library module interface (if needed)
@@ -64,9 +64,16 @@ echo "Preparing standard library modules..."
 echo "Compiling cvector module..."
 $CXX $CXXFLAGS -c cvector_module.cpp -o cvector_module.o
 
-# Step 3: Compile and link the test program
-echo "Compiling test program..."
-$CXX $CXXFLAGS cvector_module.o test_cvector.cpp -o cvector_test
+echo "Compiling deque module..."
+$CXX $CXXFLAGS -c deque_module.cpp -o deque_module.o
+
+echo "Compiling cvector_simd kernels..."
+$CXX -std=c++23 -O2 -Wall -Wextra -c cvector_simd.cpp -o cvector_simd.o
+
+# Step 3: Compile and link the test programs
+echo "Compiling test programs..."
+$CXX $CXXFLAGS cvector_module.o cvector_simd.o test_cvector.cpp -o cvector_test -pthread
+$CXX $CXXFLAGS cvector_module.o cvector_simd.o deque_module.o test_deque.cpp -o deque_test
 
 echo "Build completed successfully!"
-echo "Run with: ./cvector_test"
+echo "Run with: ./cvector_test and ./deque_test"
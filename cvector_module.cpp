@@ -3,7 +3,10 @@ module;
 // Traditional includes in global module fragment
 #include <type_traits>
 #include <memory>
+#include <memory_resource>
+#include <utility>
 #include <cstdlib>
+#include <cstddef>
 #include <cstring>  // for memcpy
 #include <iterator>
 #include <bit>
@@ -11,189 +14,1418 @@ module;
 #include <stdexcept>
 #include <iostream>
 #include <algorithm>
+#include <numeric>
+#include <concepts>
 #include <vector>
+#include <span>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <string>
+#include <system_error>
+#include <cstdint>
+#include <cerrno>
+#include <mutex>
+#include "cvector_simd.h"
+#if __has_include(<sys/mman.h>)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 export module cvector;
 
 export namespace containers {
 
+// hardened mode, enabled by building the module with CVECTOR_HARDENED defined
+// cvector then aborts on out-of-range indices, front()/back() on an empty vector and iterators used after
+// the buffer was reallocated; without it the checks compile away and access is unchanged
+#ifdef CVECTOR_HARDENED
+inline constexpr bool cvector_hardened = true;
+#else
+inline constexpr bool cvector_hardened = false;
+#endif
+
+[[noreturn]] inline void hardening_failure(const char* what) {
+    std::cerr << "cvector hardening check failed: " << what << std::endl;
+    std::abort();
+}
+
+// types whose objects can be moved to a new address by copying their bytes, without running the move
+// constructor and destructor; cvector then grows, shrinks, unwraps and shifts them with memcpy/memmove
+// true for trivially copyable types; specialize it for your own types that hold no pointer into themselves
+// and are not registered anywhere by address:
+//   template <> struct containers::is_trivially_relocatable<my_type> : std::true_type {};
+template <typename T>
+struct is_trivially_relocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v = is_trivially_relocatable<T>::value;
+
+template <typename T>
+struct is_trivially_relocatable<std::unique_ptr<T>> : std::true_type {};
+template <typename T>
+struct is_trivially_relocatable<std::shared_ptr<T>> : std::true_type {};
+template <typename T>
+struct is_trivially_relocatable<std::weak_ptr<T>> : std::true_type {};
+template <typename A, typename B>
+struct is_trivially_relocatable<std::pair<A, B>>
+    : std::bool_constant<is_trivially_relocatable_v<A> && is_trivially_relocatable_v<B>> {};
+#ifndef _GLIBCXX_DEBUG
+// the debug mode vector keeps a list of its iterators that points back at it
+template <typename T>
+struct is_trivially_relocatable<std::vector<T>> : std::true_type {};
+#endif
+#ifdef _LIBCPP_VERSION
+// libstdc++ strings point into themselves while the characters fit in the small string buffer, libc++ strings do not
+template <typename CharT, typename Traits>
+struct is_trivially_relocatable<std::basic_string<CharT, Traits>> : std::true_type {};
+#endif
+
+// default cvector allocator, backed by malloc/free
+// provides reallocate so trivially copyable rings can grow in place with realloc
+// every block starts at a multiple of alignment, e.g. Alignment = 64 puts the elements on cache line boundaries;
+// over-aligned blocks are also rounded up to a whole multiple of alignment, so no other block shares their last line
+template <typename T, size_t Alignment = alignof(std::max_align_t)>
+struct malloc_allocator {
+    static_assert(std::has_single_bit(Alignment), "Alignment must be a power of 2");
+
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = malloc_allocator<U, Alignment>;
+    };
+
+    static constexpr size_t alignment = std::max(Alignment, alignof(T));
+
+    malloc_allocator() noexcept = default;
+    template <typename U, size_t A>
+    malloc_allocator(const malloc_allocator<U, A>&) noexcept {}
+
+    T* allocate(size_t n) {
+        void* p;
+        if constexpr (alignment > alignof(std::max_align_t)) {
+            // aligned_alloc requires the size to be a multiple of the alignment
+            p = std::aligned_alloc(alignment, (n * sizeof(T) + alignment - 1) & ~(alignment - 1));
+        } else {
+            p = std::malloc(n * sizeof(T));
+        }
+        if (!p) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, size_t) noexcept {
+        std::free(p);
+    }
+
+    // resize the block at p from old_n to new_n elements, keeping the first old_n elements
+    // only used for trivially relocatable T
+    T* reallocate(T* p, size_t old_n, size_t new_n) {
+        if constexpr (alignment > alignof(std::max_align_t)) {
+            // realloc does not preserve over-alignment
+            T* new_p = allocate(new_n);
+            if (p) {
+                memcpy(static_cast<void*>(new_p), p, std::min(old_n, new_n) * sizeof(T));
+                std::free(p);
+            }
+            return new_p;
+        } else {
+            void* new_p = std::realloc(static_cast<void*>(p), new_n * sizeof(T));
+            if (!new_p) {
+                throw std::bad_alloc();
+            }
+            return static_cast<T*>(new_p);
+        }
+    }
+
+    friend bool operator==(const malloc_allocator&, const malloc_allocator&) noexcept {
+        return true;
+    }
+};
+
+// alignment of every block Allocator returns for T: Allocator::alignment if it states one, else alignof(T)
+template <typename Allocator, typename T>
+constexpr size_t allocator_alignment() {
+    if constexpr (requires { Allocator::alignment; }) {
+        return std::max<size_t>(Allocator::alignment, alignof(T));
+    } else {
+        return alignof(T);
+    }
+}
+
+// allocators that can resize a block in place, like realloc
+template <typename Allocator, typename T>
+concept reallocating_allocator = requires(Allocator& alloc, T* p, size_t n) {
+    { alloc.reallocate(p, n, n) } -> std::same_as<T*>;
+};
+
+#if __has_include(<sys/mman.h>)
+// how mmap_allocator asks for huge pages
+enum class huge_pages {
+    none,
+    // madvise(MADV_HUGEPAGE): let the kernel back the mapping with transparent huge pages when it can
+    transparent,
+    // MAP_HUGETLB: take pages from the reserved huge page pool, falling back to transparent if the pool is empty
+    reserved
+};
+
+// allocator backed by anonymous mmap, for very large rings
+// every block is its own mapping, rounded up to whole pages (2MiB pages unless Pages is huge_pages::none)
+// reallocate uses mremap where available, which moves the page tables instead of copying the data
+template <typename T, huge_pages Pages = huge_pages::none>
+struct mmap_allocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = mmap_allocator<U, Pages>;
+    };
+
+    static constexpr size_t huge_page_size = size_t(2) << 20;
+
+    mmap_allocator() noexcept = default;
+    template <typename U>
+    mmap_allocator(const mmap_allocator<U, Pages>&) noexcept {}
+
+    // length of the mapping that holds n elements
+    static size_t mapping_size(size_t n) {
+        static const size_t page = Pages == huge_pages::none ? static_cast<size_t>(sysconf(_SC_PAGESIZE)) : huge_page_size;
+        return (n * sizeof(T) + page - 1) & ~(page - 1);
+    }
+
+    static void* map(size_t bytes) {
+        void* p = MAP_FAILED;
+#ifdef MAP_HUGETLB
+        if constexpr (Pages == huge_pages::reserved) {
+            p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        }
+#endif
+        if (p == MAP_FAILED) {
+            p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            advise(p, bytes);
+        }
+        return p;
+    }
+
+    static void advise([[maybe_unused]] void* p, [[maybe_unused]] size_t bytes) noexcept {
+#ifdef MADV_HUGEPAGE
+        if constexpr (Pages != huge_pages::none) {
+            madvise(p, bytes, MADV_HUGEPAGE);
+        }
+#endif
+    }
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(map(mapping_size(n)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        munmap(p, mapping_size(n));
+    }
+
+    // resize the mapping at p from old_n to new_n elements, keeping the first old_n elements
+    T* reallocate(T* p, size_t old_n, size_t new_n) {
+        if (!p) {
+            return allocate(new_n);
+        }
+        size_t old_bytes = mapping_size(old_n);
+        size_t new_bytes = mapping_size(new_n);
+        if (old_bytes == new_bytes) {
+            return p;
+        }
+#ifdef MREMAP_MAYMOVE
+        void* remapped = mremap(p, old_bytes, new_bytes, MREMAP_MAYMOVE);
+        if (remapped != MAP_FAILED) {
+            if (new_bytes > old_bytes) {
+                advise(remapped, new_bytes);
+            }
+            return static_cast<T*>(remapped);
+        }
+#endif
+        // no mremap, or the kernel refused to remap (older kernels cannot remap huge page mappings)
+        T* new_p = allocate(new_n);
+        memcpy(new_p, p, std::min(old_bytes, new_bytes));
+        munmap(p, old_bytes);
+        return new_p;
+    }
+
+    friend bool operator==(const mmap_allocator&, const mmap_allocator&) noexcept {
+        return true;
+    }
+};
+#endif
+
+#if defined(MFD_CLOEXEC)
+// allocator for "magic" ring buffers: the same pages are mapped twice, back to back
+// element i and element i + n of an n element block share memory, so any window of up to n elements
+// starting inside the block is contiguous
+// n * sizeof(T) must be a whole number of pages, min_capacity() is the smallest power of 2 that qualifies
+// cvector detects this allocator (see mirroring_allocator) and never wraps a run in two
+template <typename T>
+struct mirrored_allocator {
+    static_assert(std::is_trivially_copyable_v<T>, "mirrored memory holds every object at two addresses");
+
+    using value_type = T;
+
+    static constexpr bool mirrored = true;
+
+    mirrored_allocator() noexcept = default;
+    template <typename U>
+    mirrored_allocator(const mirrored_allocator<U>&) noexcept {}
+
+    static size_t page_size() {
+        static const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        return page;
+    }
+
+    // the power of 2 part of sizeof(T) covers that much of a page, the rest of the page needs more elements
+    static size_t min_capacity() {
+        return std::max<size_t>(page_size() >> std::countr_zero(sizeof(T)), 1);
+    }
+
+    T* allocate(size_t n) {
+        size_t bytes = n * sizeof(T);
+        if (bytes % page_size() != 0) {
+            throw std::invalid_argument("mirrored_allocator::allocate: size is not a multiple of the page size");
+        }
+        int fd = memfd_create("cvector", MFD_CLOEXEC);
+        if (fd < 0) {
+            throw std::bad_alloc();
+        }
+        // reserve address space for both copies, then map the file over each half
+        void* base = MAP_FAILED;
+        if (ftruncate(fd, static_cast<off_t>(bytes)) == 0) {
+            base = mmap(nullptr, 2 * bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        }
+        if (base != MAP_FAILED) {
+            char* first = static_cast<char*>(base);
+            if (mmap(first, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED ||
+                mmap(first + bytes, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) == MAP_FAILED) {
+                munmap(base, 2 * bytes);
+                base = MAP_FAILED;
+            }
+        }
+        // the mappings keep the memory alive
+        close(fd);
+        if (base == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(base);
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        munmap(p, 2 * n * sizeof(T));
+    }
+
+    // the block is remapped from scratch, so the first min(old_n, new_n) elements are copied
+    T* reallocate(T* p, size_t old_n, size_t new_n) {
+        T* new_p = allocate(new_n);
+        if (p) {
+            memcpy(new_p, p, std::min(old_n, new_n) * sizeof(T));
+            deallocate(p, old_n);
+        }
+        return new_p;
+    }
+
+    friend bool operator==(const mirrored_allocator&, const mirrored_allocator&) noexcept {
+        return true;
+    }
+};
+#endif
+
+// allocators whose blocks of n elements are followed by a mirror of themselves, like mirrored_allocator
+template <typename Allocator>
+concept mirroring_allocator = Allocator::mirrored && requires {
+    { Allocator::min_capacity() } -> std::convertible_to<size_t>;
+};
+
+// cvector stats policies
+// cvector reports grows, shrinks, relocations and wrap-arounds to its Stats parameter
+// no_stats ignores them and compiles away entirely, cvector_stats counts them and registers itself in
+// cvector_stats_registry so the counters of every live ring can be exported
+struct no_stats {
+    void record_grow(size_t) noexcept {}
+    void record_shrink(size_t) noexcept {}
+    void record_capacity(size_t) noexcept {}
+    void record_relocation(size_t, bool) noexcept {}
+    void record_wrap() noexcept {}
+};
+
+// point-in-time copy of the counters of one cvector_stats
+struct cvector_stats_snapshot {
+    const char* label = "";
+    size_t grow_events = 0;
+    size_t shrink_events = 0;
+    // relocations done with reallocate, and with a fresh buffer plus copy or move
+    size_t in_place_relocations = 0;
+    size_t copy_relocations = 0;
+    // bytes copied or moved by cvector itself (not counting what realloc does internally)
+    size_t bytes_copied = 0;
+    // times the back or the front of the ring crossed the end of the buffer
+    size_t wraps = 0;
+    size_t capacity_bytes = 0;
+    size_t peak_capacity_bytes = 0;
+};
+
+// counters are written only by the thread that owns the cvector, and can be read from any thread
+// a copied or moved cvector starts with fresh counters
+class cvector_stats {
+    private:
+        const char* label_;
+        std::atomic<size_t> grow_events_;
+        std::atomic<size_t> shrink_events_;
+        std::atomic<size_t> in_place_relocations_;
+        std::atomic<size_t> copy_relocations_;
+        std::atomic<size_t> bytes_copied_;
+        std::atomic<size_t> wraps_;
+        std::atomic<size_t> capacity_bytes_;
+        std::atomic<size_t> peak_capacity_bytes_;
+
+        // single writer, so a plain load and store is enough
+        static void add(std::atomic<size_t>& counter, size_t n) noexcept {
+            counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+
+    public:
+        cvector_stats();
+        cvector_stats(const cvector_stats&) = delete;
+        cvector_stats& operator=(const cvector_stats&) = delete;
+        ~cvector_stats();
+
+        // name shown in exported stats, must outlive the cvector
+        void set_label(const char* label) noexcept {
+            label_ = label;
+        }
+
+        void record_grow(size_t capacity_bytes) noexcept {
+            add(grow_events_, 1);
+            record_capacity(capacity_bytes);
+        }
+        void record_shrink(size_t capacity_bytes) noexcept {
+            add(shrink_events_, 1);
+            record_capacity(capacity_bytes);
+        }
+        void record_capacity(size_t capacity_bytes) noexcept {
+            capacity_bytes_.store(capacity_bytes, std::memory_order_relaxed);
+            if (capacity_bytes > peak_capacity_bytes_.load(std::memory_order_relaxed)) {
+                peak_capacity_bytes_.store(capacity_bytes, std::memory_order_relaxed);
+            }
+        }
+        void record_relocation(size_t bytes_copied, bool in_place) noexcept {
+            add(in_place ? in_place_relocations_ : copy_relocations_, 1);
+            add(bytes_copied_, bytes_copied);
+        }
+        void record_wrap() noexcept {
+            add(wraps_, 1);
+        }
+
+        cvector_stats_snapshot snapshot() const noexcept {
+            cvector_stats_snapshot s;
+            s.label = label_;
+            s.grow_events = grow_events_.load(std::memory_order_relaxed);
+            s.shrink_events = shrink_events_.load(std::memory_order_relaxed);
+            s.in_place_relocations = in_place_relocations_.load(std::memory_order_relaxed);
+            s.copy_relocations = copy_relocations_.load(std::memory_order_relaxed);
+            s.bytes_copied = bytes_copied_.load(std::memory_order_relaxed);
+            s.wraps = wraps_.load(std::memory_order_relaxed);
+            s.capacity_bytes = capacity_bytes_.load(std::memory_order_relaxed);
+            s.peak_capacity_bytes = peak_capacity_bytes_.load(std::memory_order_relaxed);
+            return s;
+        }
+};
+
+// every live cvector_stats, plus the summed counters of destroyed ones
+class cvector_stats_registry {
+    private:
+        std::mutex mutex_;
+        std::vector<const cvector_stats*> live_;
+        cvector_stats_snapshot retired_;
+
+        friend class cvector_stats;
+
+        void add(const cvector_stats* stats) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            live_.push_back(stats);
+        }
+
+        void remove(const cvector_stats* stats) noexcept {
+            cvector_stats_snapshot s = stats->snapshot();
+            std::lock_guard<std::mutex> lock(mutex_);
+            live_.erase(std::find(live_.begin(), live_.end(), stats));
+            retired_.grow_events += s.grow_events;
+            retired_.shrink_events += s.shrink_events;
+            retired_.in_place_relocations += s.in_place_relocations;
+            retired_.copy_relocations += s.copy_relocations;
+            retired_.bytes_copied += s.bytes_copied;
+            retired_.wraps += s.wraps;
+            retired_.peak_capacity_bytes = std::max(retired_.peak_capacity_bytes, s.peak_capacity_bytes);
+        }
+
+    public:
+        static cvector_stats_registry& instance() {
+            static cvector_stats_registry registry;
+            return registry;
+        }
+
+        // call f with a snapshot of every live ring, while holding the registry lock
+        template <typename F>
+        void for_each(F f) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const cvector_stats* stats : live_) {
+                f(stats->snapshot());
+            }
+        }
+
+        // counters summed over destroyed rings, peak_capacity_bytes is the largest single peak
+        cvector_stats_snapshot retired() {
+            std::lock_guard<std::mutex> lock(mutex_);
+            return retired_;
+        }
+};
+
+inline cvector_stats::cvector_stats()
+    : label_(""), grow_events_(0), shrink_events_(0), in_place_relocations_(0), copy_relocations_(0), bytes_copied_(0),
+      wraps_(0), capacity_bytes_(0), peak_capacity_bytes_(0) {
+    cvector_stats_registry::instance().add(this);
+}
+
+inline cvector_stats::~cvector_stats() {
+    cvector_stats_registry::instance().remove(this);
+}
+
+// cvector growth policy: next_capacity(capacity) is the capacity a full ring grows to
+// the result must be a power of 2 greater than capacity, since indices are masked with capacity - 1
+// doubling_growth doubles, but starts at InitialCapacity instead of 1 to skip the first few tiny allocations
+template <size_t InitialCapacity = 1>
+struct doubling_growth {
+    static_assert(std::has_single_bit(InitialCapacity), "InitialCapacity must be a power of 2");
+
+    static constexpr size_t next_capacity(size_t capacity) noexcept {
+        return capacity ? capacity * 2 : InitialCapacity;
+    }
+};
+
+// first allocation fills a whole cache line
+template <typename T>
+using cache_line_growth = doubling_growth<std::max<size_t>(std::bit_floor(64 / sizeof(T)), 1)>;
+
 // circular vector
 // capacity is always a power of 2 (or 0)
-template <typename T>
+// memory comes from Allocator through std::allocator_traits
+// the first InlineCapacity elements are stored inside the cvector itself, the heap is only used once they overflow
+// Growth decides how far a full ring grows, see doubling_growth
+// Stats receives grow, shrink, relocation and wrap-around events, see no_stats and cvector_stats
+template <typename T, typename Allocator = malloc_allocator<T>, size_t InlineCapacity = 0, typename Growth = doubling_growth<>,
+          typename Stats = no_stats>
 class cvector {
+    static_assert(InlineCapacity == 0 || std::has_single_bit(InlineCapacity), "InlineCapacity must be a power of 2");
+    static_assert(InlineCapacity == 0 || !mirroring_allocator<Allocator>, "an inline buffer cannot be mirrored");
+
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using size_type = size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference = T&;
+        using const_reference = const T&;
+
+        // every buffer, inline or allocated, starts at a multiple of this
+        static constexpr size_t alignment = allocator_alignment<Allocator, T>();
+
     private:
+        using alloc_traits = std::allocator_traits<Allocator>;
+
+        // the buffer is followed by a mirror of itself, so no run of elements ever wraps
+        static constexpr bool mirrored_ = mirroring_allocator<Allocator>;
+
+        // counts buffer changes in hardened mode, so iterators can tell that they were invalidated
+        struct no_generation {
+            size_t value() const noexcept { return 0; }
+            void bump() noexcept {}
+        };
+        struct generation {
+            size_t value_ = 0;
+            size_t value() const noexcept { return value_; }
+            void bump() noexcept { ++value_; }
+        };
+        using generation_type = std::conditional_t<cvector_hardened, generation, no_generation>;
+
+        // storage for the inline elements, only instantiated when InlineCapacity > 0
+        struct no_inline_buffer {
+            T* data() noexcept { return nullptr; }
+            const T* data() const noexcept { return nullptr; }
+        };
+        struct inline_buffer {
+            alignas(alignment) unsigned char bytes_[InlineCapacity * sizeof(T)];
+            T* data() noexcept { return reinterpret_cast<T*>(bytes_); }
+            const T* data() const noexcept { return reinterpret_cast<const T*>(bytes_); }
+        };
+
         T* data_;
         size_t size_;
         size_t capacity_;
         size_t head_;
+        // automatic shrinking: halve the capacity once size drops below a quarter of it,
+        // but never below this floor (a power of 2), 0 disables it
+        size_t auto_shrink_floor_;
+        [[no_unique_address]] Allocator alloc_;
+        [[no_unique_address]] std::conditional_t<InlineCapacity == 0, no_inline_buffer, inline_buffer> inline_;
+        [[no_unique_address]] Stats stats_;
+        [[no_unique_address]] generation_type generation_;
+
+        void check_index(size_t index) const {
+            if constexpr (cvector_hardened) {
+                if (index >= size_) {
+                    hardening_failure("index out of range");
+                }
+            }
+        }
+
+        T* allocate(size_t n) {
+            return std::to_address(alloc_traits::allocate(alloc_, n));
+        }
+
+        void deallocate(T* p, size_t n) {
+            if (p && p != inline_.data()) {
+                alloc_traits::deallocate(alloc_, p, n);
+            }
+        }
+
+        bool is_inline() const {
+            if constexpr (InlineCapacity > 0) {
+                return data_ == inline_.data();
+            } else {
+                return false;
+            }
+        }
+
+        // the capacity to use for a buffer of at least n elements, a mirrored buffer cannot be smaller than a page
+        static size_t usable_capacity(size_t n) {
+            if constexpr (mirrored_) {
+                return n ? std::max<size_t>(n, Allocator::min_capacity()) : 0;
+            } else {
+                return n;
+            }
+        }
+
+        // a buffer of n elements to relocate into: the inline buffer if it is free and large enough, else the heap
+        T* acquire(size_t n) {
+            if constexpr (InlineCapacity > 0) {
+                if (n <= InlineCapacity && !is_inline()) {
+                    return inline_.data();
+                }
+            }
+            return allocate(n);
+        }
+
+        // point at the inline buffer (or no buffer), without touching elements or freeing anything
+        void reset_buffer() noexcept {
+            data_ = inline_.data();
+            capacity_ = InlineCapacity;
+            head_ = 0;
+        }
+
+        // destroy all elements and release the buffer, leaving *this empty
+        void release() {
+            clear();
+            generation_.bump();
+            deallocate(data_, capacity_);
+            reset_buffer();
+            stats_.record_capacity(capacity_ * sizeof(T));
+        }
+
+        // take over the buffer of other, which is left empty
+        // assume *this is empty and holds no heap buffer
+        // inline elements cannot change owner, so they are moved into our own inline buffer at the same slots
+        // inline elements are copied instead if their move constructor may throw (std::move_if_noexcept)
+        // only throws if copying or moving an inline element throws, other is unchanged then
+        void steal(cvector& other) {
+            generation_.bump();
+            other.generation_.bump();
+            // the shrink policy travels with the elements, through move construction, assignment and swap alike
+            auto_shrink_floor_ = other.auto_shrink_floor_;
+            if constexpr (InlineCapacity > 0) {
+                if (other.is_inline()) {
+                    size_t size = other.size_;
+                    size_t head = other.head_;
+                    if constexpr (is_trivially_relocatable_v<T>) {
+                        memcpy(static_cast<void*>(inline_.data()), other.inline_.data(), InlineCapacity * sizeof(T));
+                    } else {
+                        size_t moved = 0;
+                        try {
+                            for (; moved < size; ++moved) {
+                                size_t index = (head + moved) & (InlineCapacity - 1);
+                                alloc_traits::construct(alloc_, inline_.data() + index, std::move_if_noexcept(other.data_[index]));
+                            }
+                        } catch (...) {
+                            for (size_t i = 0; i < moved; ++i) {
+                                alloc_traits::destroy(alloc_, inline_.data() + ((head + i) & (InlineCapacity - 1)));
+                            }
+                            throw;
+                        }
+                        other.clear();
+                    }
+                    data_ = inline_.data();
+                    size_ = size;
+                    capacity_ = InlineCapacity;
+                    head_ = head;
+                    other.size_ = 0;
+                    other.head_ = 0;
+                    stats_.record_capacity(capacity_ * sizeof(T));
+                    return;
+                }
+            }
+            data_ = other.data_;
+            size_ = other.size_;
+            capacity_ = other.capacity_;
+            head_ = other.head_;
+            other.reset_buffer();
+            other.size_ = 0;
+            stats_.record_capacity(capacity_ * sizeof(T));
+            other.stats_.record_capacity(other.capacity_ * sizeof(T));
+        }
+
+        // shrink capacity to new_capacity, unwrapping the ring on the way
+        // assume new_capacity is a power of 2 (or 0), less than the current capacity and at least size_ and InlineCapacity
+        // shrinking to InlineCapacity moves the elements back into the inline buffer
+        void shrink_capacity(size_t new_capacity) {
+            generation_.bump();
+            if (new_capacity == 0) {
+                deallocate(data_, capacity_);
+                reset_buffer();
+                return;
+            }
+            if constexpr (is_trivially_relocatable_v<T> && reallocating_allocator<Allocator, T>) {
+                if (new_capacity > InlineCapacity) {
+                    // move the elements to the front of the buffer, then let realloc release the tail
+                    if (head_ + size_ > capacity_) {
+                        // wrapped: size_ <= capacity_ / 2 <= head_, so the runs can be moved without overlap
+                        size_t first = capacity_ - head_;
+                        memmove(static_cast<void*>(data_ + first), data_, (size_ - first) * sizeof(T));
+                        memcpy(static_cast<void*>(data_), data_ + head_, first * sizeof(T));
+                        head_ = 0;
+                    } else if (head_ + size_ > new_capacity) {
+                        memmove(static_cast<void*>(data_), data_ + head_, size_ * sizeof(T));
+                        head_ = 0;
+                    }
+                    data_ = alloc_.reallocate(data_, capacity_, new_capacity);
+                    capacity_ = new_capacity;
+                    if (size_ > 0) {
+                        stats_.record_relocation(0, true);
+                    }
+                    return;
+                }
+            }
+            if constexpr (is_trivially_relocatable_v<T>) {
+                relocate_trivial(new_capacity);
+            } else {
+                grow_capacity_non_trivial(new_capacity);
+            }
+        }
+
+        // called after an element is removed
+        // shrinking is only an optimization, so if the smaller buffer cannot be allocated or an element cannot be
+        // copied into it, the current one is kept (a failed relocation leaves the ring unchanged)
+        void maybe_auto_shrink() {
+            if (auto_shrink_floor_ && size_ < capacity_ / 4 && capacity_ > auto_shrink_floor_ && capacity_ > InlineCapacity &&
+                usable_capacity(capacity_ / 2) == capacity_ / 2) {
+                try {
+                    shrink_capacity(capacity_ / 2);
+                    stats_.record_shrink(capacity_ * sizeof(T));
+                } catch (...) {
+                }
+            }
+        }
+
+        // grow so that at least required elements fit, by at least one step of the growth policy
+        void grow_for(size_t required) {
+            if (required > capacity_) {
+                grow_capacity(std::max(std::bit_ceil(required), Growth::next_capacity(capacity_)));
+            }
+        }
 
         // grow capacity to new_capacity
         // assume new_capacity is a power of 2 and is greater than current capacity
         inline void grow_capacity(size_t new_capacity) {
-            if constexpr (std::is_trivially_copyable_v<T>) {
+            generation_.bump();
+            new_capacity = usable_capacity(new_capacity);
+            if constexpr (is_trivially_relocatable_v<T>) {
                 grow_capacity_trivial(new_capacity);
             } else {
                 grow_capacity_non_trivial(new_capacity);
             }
+            stats_.record_grow(capacity_ * sizeof(T));
         }
 
-        // For trivially copyable types - can use realloc/memcpy
+        // For trivially relocatable types - can use realloc/memcpy
+        // (destinations are passed as void* since T need not be trivially copyable)
+        // realloc can grow in place, and large blocks are moved with mremap instead of copied,
+        // so the old and new buffers do not have to exist side by side
         inline void grow_capacity_trivial(size_t new_capacity) {
-            if (head_ + size_ <= capacity_) {
-                // use realloc since data doesn't wrap around
-                data_ = (T*)realloc(data_, new_capacity * sizeof(T));
-            } else {
-                // use memcpy since data wraps around
-                T* new_data = (T*)malloc(new_capacity * sizeof(T));
-                memcpy(new_data, data_ + head_, (capacity_ - head_) * sizeof(T));
-                memcpy(new_data + (capacity_ - head_), data_, (head_ + size_ - capacity_) * sizeof(T));
-                free(data_);
-                data_ = new_data;
-                head_ = 0;
+            if constexpr (reallocating_allocator<Allocator, T>) {
+                if (!is_inline()) {
+                    size_t old_capacity = capacity_;
+                    data_ = alloc_.reallocate(data_, capacity_, new_capacity);
+                    capacity_ = new_capacity;
+                    size_t copied = 0;
+                    if (head_ + size_ > old_capacity) {
+                        // the ring wrapped: [head_, old_capacity) is followed by [0, wrapped)
+                        // copy the shorter run into the new space so the ring stays in order
+                        size_t wrapped = head_ + size_ - old_capacity;
+                        size_t first = old_capacity - head_;
+                        if (wrapped <= first) {
+                            memcpy(static_cast<void*>(data_ + old_capacity), data_, wrapped * sizeof(T));
+                            copied = wrapped;
+                        } else {
+                            memcpy(static_cast<void*>(data_ + new_capacity - first), data_ + head_, first * sizeof(T));
+                            head_ = new_capacity - first;
+                            copied = first;
+                        }
+                    }
+                    if (size_ > 0) {
+                        stats_.record_relocation(copied * sizeof(T), true);
+                    }
+                    return;
+                }
+            }
+            // use memcpy since data is inline or the allocator cannot reallocate
+            relocate_trivial(new_capacity);
+        }
+
+        // For trivially relocatable types - copy both runs into a new buffer with head at 0
+        // the old buffer is freed without destroying anything, the objects now live in the new one
+        void relocate_trivial(size_t new_capacity) {
+            T* new_data = acquire(new_capacity);
+            if (size_ > 0) {
+                size_t first = std::min(size_, capacity_ - head_);
+                memcpy(static_cast<void*>(new_data), data_ + head_, first * sizeof(T));
+                memcpy(static_cast<void*>(new_data + first), data_, (size_ - first) * sizeof(T));
             }
+            deallocate(data_, capacity_);
+            data_ = new_data;
+            head_ = 0;
             capacity_ = new_capacity;
+            if (size_ > 0) {
+                stats_.record_relocation(size_ * sizeof(T), false);
+            }
         }
 
-        // For non-trivially copyable types - use proper construction/destruction
+        // For other types - use proper construction/destruction
+        // elements are moved if that cannot throw, otherwise copied (std::move_if_noexcept), so when a constructor
+        // throws the new buffer is discarded and the ring is left exactly as it was
+        // only a type that can neither be copied nor moved without throwing can be left with moved-from elements
+        // also used to shrink or unwrap, new_capacity only needs to be at least size_
         inline void grow_capacity_non_trivial(size_t new_capacity) {
-            T* new_data = static_cast<T*>(std::aligned_alloc(alignof(T), new_capacity * sizeof(T)));
+            T* new_data = acquire(new_capacity);
             
             // Move/copy construct all existing elements to new location
-            for (size_t i = 0; i < size_; ++i) {
-                size_t old_index = (head_ + i) & (capacity_ - 1);
-                if constexpr (std::is_move_constructible_v<T>) {
-                    new (new_data + i) T(std::move(data_[old_index]));
-                } else {
-                    new (new_data + i) T(data_[old_index]);
+            size_t constructed = 0;
+            try {
+                for (; constructed < size_; ++constructed) {
+                    size_t old_index = (head_ + constructed) & (capacity_ - 1);
+                    alloc_traits::construct(alloc_, new_data + constructed, std::move_if_noexcept(data_[old_index]));
+                }
+            } catch (...) {
+                for (size_t i = 0; i < constructed; ++i) {
+                    alloc_traits::destroy(alloc_, new_data + i);
                 }
+                deallocate(new_data, new_capacity);
+                throw;
             }
             
             // Destroy all objects in old memory
             if constexpr (!std::is_trivially_destructible_v<T>) {
                 for (size_t i = 0; i < size_; ++i) {
                     size_t old_index = (head_ + i) & (capacity_ - 1);
-                    data_[old_index].~T();
+                    alloc_traits::destroy(alloc_, data_ + old_index);
                 }
             }
             
-            std::free(data_);
+            deallocate(data_, capacity_);
             data_ = new_data;
             head_ = 0;
             capacity_ = new_capacity;
+            if (size_ > 0) {
+                stats_.record_relocation(size_ * sizeof(T), false);
+            }
         }
 
-    public:
-        cvector() : data_(nullptr), size_(0), capacity_(0), head_(0) {}
-        
-        cvector(size_t initial_size) : data_(nullptr), size_(0), capacity_(0), head_(0) {
-            if (initial_size > 0) {
-                capacity_ = std::bit_ceil(initial_size);
-                data_ = static_cast<T*>(std::aligned_alloc(alignof(T), capacity_ * sizeof(T)));
-                
-                if (!data_) {
-                    throw std::bad_alloc();
+        // For trivially relocatable types - make a wrapped ring contiguous without leaving its buffer
+        // the run before the wrap point [head_, capacity_) is `first` long, the wrapped run [0, wrapped) follows it,
+        // and the free slots in between are `gap` long; only the elements are moved, never the free slots
+        void unwrap_trivial() noexcept {
+            size_t first = capacity_ - head_;
+            size_t wrapped = size_ - first;
+            size_t gap = capacity_ - size_;
+            if (first <= gap) {
+                // the wrapped run moves up to make room, then the first run goes in front of it
+                memmove(static_cast<void*>(data_ + first), data_, wrapped * sizeof(T));
+                memcpy(static_cast<void*>(data_), data_ + head_, first * sizeof(T));
+                head_ = 0;
+            } else {
+                // the first run moves down behind the wrapped run
+                memmove(static_cast<void*>(data_ + wrapped), data_ + head_, first * sizeof(T));
+                if (wrapped <= gap) {
+                    // and the wrapped run moves behind it
+                    memcpy(static_cast<void*>(data_ + size_), data_, wrapped * sizeof(T));
+                    head_ = wrapped;
+                } else if constexpr (std::is_trivially_copyable_v<T>) {
+                    // neither run fits in the gap, so the two runs swap places in O(size_)
+                    std::rotate(data_, data_ + wrapped, data_ + size_);
+                    head_ = 0;
+                } else {
+                    // the same, but as bytes: swapping would call the move constructor and assignment
+                    unsigned char* bytes = reinterpret_cast<unsigned char*>(data_);
+                    std::rotate(bytes, bytes + wrapped * sizeof(T), bytes + size_ * sizeof(T));
+                    head_ = 0;
                 }
-                
-                // Default construct initial_size elements
+            }
+        }
+
+        // For trivially relocatable types - move n elements from logical index src to logical index dst with memmove
+        // the ranges may overlap, so chunks are taken from the front when moving towards head and from the back otherwise
+        // each chunk is contiguous in both the source and the destination
+        void move_elements_trivial(size_t src, size_t dst, size_t n) {
+            if (src > dst) {
+                while (n > 0) {
+                    size_t from = (head_ + src) & (capacity_ - 1);
+                    size_t to = (head_ + dst) & (capacity_ - 1);
+                    size_t chunk = std::min({n, capacity_ - from, capacity_ - to});
+                    memmove(static_cast<void*>(data_ + to), data_ + from, chunk * sizeof(T));
+                    src += chunk;
+                    dst += chunk;
+                    n -= chunk;
+                }
+            } else if (src < dst) {
+                while (n > 0) {
+                    // physical indices of the last element of each range
+                    size_t from = (head_ + src + n - 1) & (capacity_ - 1);
+                    size_t to = (head_ + dst + n - 1) & (capacity_ - 1);
+                    size_t chunk = std::min({n, from + 1, to + 1});
+                    memmove(static_cast<void*>(data_ + to + 1 - chunk), data_ + from + 1 - chunk, chunk * sizeof(T));
+                    n -= chunk;
+                }
+            }
+        }
+
+        // construct n elements from first into uninitialized slots starting at physical index start
+        // the slots form at most two contiguous runs: [start, capacity_) and [0, rest)
+        // on exception every element constructed here is destroyed again
+        template <typename InputIt>
+        void construct_range(size_t start, InputIt first, size_t n) {
+            size_t first_run = std::min(n, capacity_ - start);
+            if constexpr (std::is_trivially_copyable_v<T> && std::contiguous_iterator<InputIt> &&
+                          std::is_same_v<std::remove_cv_t<std::iter_value_t<InputIt>>, T>) {
+                if (n == 0) {
+                    return;
+                }
+                const T* src = std::to_address(first);
+                memcpy(data_ + start, src, first_run * sizeof(T));
+                memcpy(data_, src + first_run, (n - first_run) * sizeof(T));
+            } else {
+                size_t constructed = 0;
                 try {
-                    while (size_ < initial_size) {
-                        new (data_ + size_) T{};  // Value initialization
-                        ++size_;
+                    for (; constructed < first_run; ++constructed, ++first) {
+                        alloc_traits::construct(alloc_, data_ + start + constructed, *first);
+                    }
+                    for (; constructed < n; ++constructed, ++first) {
+                        alloc_traits::construct(alloc_, data_ + constructed - first_run, *first);
                     }
                 } catch (...) {
-                    // Clean up any already-constructed objects
-                    for (size_t i = 0; i < size_; ++i) {
-                        data_[i].~T();
+                    for (size_t i = 0; i < constructed; ++i) {
+                        alloc_traits::destroy(alloc_, data_ + ((start + i) & (capacity_ - 1)));
                     }
-                    std::free(data_);
-                    data_ = nullptr;
-                    size_ = 0;
-                    capacity_ = 0;
                     throw;
                 }
             }
         }
 
-        ~cvector() {
-            clear();
-            std::free(data_);
+        // whether n elements added after the back element wrap around the end of the buffer, counted the way
+        // n calls to emplace_back would count it: some element lands in slot 0 while the ring is not empty
+        bool back_wraps(size_t n) const noexcept {
+            size_t to_end = (capacity_ - ((head_ + size_) & (capacity_ - 1))) & (capacity_ - 1);
+            return to_end < n && size_ + to_end > 0;
         }
 
-        void reserve(size_t new_capacity) {
-            if (new_capacity > capacity_) {
-                grow_capacity(std::bit_ceil(new_capacity));
-            }
+        // whether n elements added before the front element wrap around the start of the buffer,
+        // counted the way n calls to emplace_front would count it
+        bool front_wraps(size_t n) const noexcept {
+            return head_ < n && size_ + head_ > 0;
         }
 
-        void push_back(const T& value) {
-            if (size_ >= capacity_) {
-                size_t new_capacity = capacity_ ? capacity_ * 2 : 1;
-                grow_capacity(new_capacity);
-            }
-            
-            if constexpr (std::is_trivially_constructible_v<T>) {
-                data_[(head_ + size_) & (capacity_ - 1)] = value;
-            } else {
-                new (data_ + ((head_ + size_) & (capacity_ - 1))) T(value);
+        // construct the n elements starting at first in front of the front element, making room once
+        template <typename It>
+        void prepend_n(It first, size_t n) {
+            grow_for(size_ + n);
+            size_t new_head = (head_ - n) & (capacity_ - 1);
+            bool wraps = front_wraps(n);
+            construct_range(new_head, first, n);
+            if (wraps) {
+                stats_.record_wrap();
             }
-            size_++;
+            head_ = new_head;
+            size_ += n;
         }
 
-        void push_front(const T& value) {
-            if (size_ >= capacity_) {
-                size_t new_capacity = capacity_ ? capacity_ * 2 : 1;
-                grow_capacity(new_capacity);
+        // construct the n elements starting at first before logical index, making room once
+        // trivially relocatable elements are shifted with memmove and the range is constructed straight into the gap
+        // (with memcpy for a contiguous range of trivially copyable elements); if that throws the gap is closed again
+        // other elements are shifted with move construction and move assignment, like emplace; the range is copied
+        // into a buffer first, so a throwing copy leaves *this unchanged and a throwing move leaves every element valid
+        template <typename It>
+        void insert_n(size_t index, It first, size_t n) {
+            if (n == 0) {
+                return;
             }
-            head_ = (head_ - 1) & (capacity_ - 1);
-            
-            if constexpr (std::is_trivially_constructible_v<T>) {
-                data_[head_] = value;
+            if (index == size_) {
+                grow_for(size_ + n);
+                bool wraps = back_wraps(n);
+                construct_range((head_ + size_) & (capacity_ - 1), first, n);
+                if (wraps) {
+                    stats_.record_wrap();
+                }
+                size_ += n;
+                return;
+            }
+            if (index == 0) {
+                prepend_n(first, n);
+                return;
+            }
+            if constexpr (is_trivially_relocatable_v<T>) {
+                grow_for(size_ + n);
+                size_t old_head = head_;
+                bool front = index < size_ / 2;
+                bool wraps = front ? front_wraps(n) : back_wraps(n);
+                if (front) {
+                    head_ = (head_ - n) & (capacity_ - 1);
+                    size_ += n;
+                    move_elements_trivial(n, 0, index);
+                } else {
+                    size_ += n;
+                    move_elements_trivial(index, index + n, size_ - n - index);
+                }
+                try {
+                    construct_range((head_ + index) & (capacity_ - 1), first, n);
+                } catch (...) {
+                    if (front) {
+                        move_elements_trivial(0, n, index);
+                    } else {
+                        move_elements_trivial(index + n, index, size_ - n - index);
+                    }
+                    head_ = old_head;
+                    size_ -= n;
+                    throw;
+                }
+                if (wraps) {
+                    stats_.record_wrap();
+                }
             } else {
-                new (data_ + head_) T(value);
+                cvector values(alloc_);
+                values.insert_n(0, first, n);
+                grow_for(size_ + n);
+                size_t old_size = size_;
+                if (index >= old_size / 2) {
+                    // elements landing past the old back are constructed there, the rest are assigned
+                    size_t after = old_size - index;
+                    size_t constructed = std::min(n, after);
+                    for (size_t i = after; i < n; ++i) {
+                        emplace_back(std::move(values[i]));
+                    }
+                    for (size_t i = old_size - constructed; i < old_size; ++i) {
+                        emplace_back(std::move((*this)[i]));
+                    }
+                    std::move_backward(begin() + index, begin() + (old_size - constructed),
+                                       begin() + (old_size - constructed + n));
+                    std::move(values.begin(), values.begin() + constructed, begin() + index);
+                } else {
+                    // elements landing before the old front are constructed there, the rest are assigned
+                    size_t constructed = std::min(n, index);
+                    for (size_t i = n - constructed; i-- > 0;) {
+                        emplace_front(std::move(values[i]));
+                    }
+                    // each emplace_front moves the old elements one position further from begin()
+                    for (size_t i = constructed, pushed = n - constructed; i-- > 0; ++pushed) {
+                        emplace_front(std::move((*this)[i + pushed]));
+                    }
+                    std::move(begin() + (constructed + n), begin() + (index + n), begin() + constructed);
+                    std::move(values.begin() + (n - constructed), values.end(), begin() + (index + n - constructed));
+                }
             }
-            size_++;
         }
 
-        void pop_back() {
-            if (size_ == 0) {
-                throw std::out_of_range("cvector::pop_back: size is 0");
+        // copy the elements of other into this empty cvector, stored unwrapped with head at 0
+        void copy_from(const cvector& other) {
+            if (other.size_ == 0) {
+                return;
             }
-            if constexpr (!std::is_trivially_destructible_v<T>) {
-                data_[(head_ + size_ - 1) & (capacity_ - 1)].~T();
+            size_t new_capacity = usable_capacity(std::bit_ceil(other.size_));
+            if (new_capacity > capacity_) {
+                data_ = allocate(new_capacity);
+                capacity_ = new_capacity;
+                stats_.record_capacity(capacity_ * sizeof(T));
+            }
+            auto [first, second] = other.as_spans();
+            try {
+                construct_range(0, first.data(), first.size());
+                size_ = first.size();
+                construct_range(size_, second.data(), second.size());
+                size_ += second.size();
+            } catch (...) {
+                release();
+                throw;
             }
-            size_--;
         }
 
-        void pop_front() {
+    public:
+        cvector() noexcept(noexcept(Allocator())) : cvector(Allocator()) {}
+
+        explicit cvector(const Allocator& alloc) noexcept
+            : data_(nullptr), size_(0), capacity_(0), head_(0), auto_shrink_floor_(0), alloc_(alloc) {
+            reset_buffer();
+        }
+        
+        cvector(size_t initial_size, const Allocator& alloc = Allocator())
+            : data_(nullptr), size_(0), capacity_(0), head_(0), auto_shrink_floor_(0), alloc_(alloc) {
+            reset_buffer();
+            if (initial_size > capacity_) {
+                capacity_ = usable_capacity(std::bit_ceil(initial_size));
+                data_ = allocate(capacity_);
+                stats_.record_capacity(capacity_ * sizeof(T));
+            }
+            
+            // Default construct initial_size elements
+            try {
+                while (size_ < initial_size) {
+                    alloc_traits::construct(alloc_, data_ + size_);  // Value initialization
+                    ++size_;
+                }
+            } catch (...) {
+                // Clean up any already-constructed objects
+                release();
+                throw;
+            }
+        }
+
+        // copy is stored unwrapped with head at 0
+        cvector(const cvector& other)
+            : cvector(other, alloc_traits::select_on_container_copy_construction(other.alloc_)) {}
+
+        cvector(const cvector& other, const Allocator& alloc)
+            : data_(nullptr), size_(0), capacity_(0), head_(0), auto_shrink_floor_(other.auto_shrink_floor_), alloc_(alloc) {
+            reset_buffer();
+            copy_from(other);
+        }
+
+        // steals the buffer, no elements are touched unless they are stored inline
+        cvector(cvector&& other) noexcept(InlineCapacity == 0 || std::is_nothrow_move_constructible_v<T>)
+            : data_(nullptr), size_(0), capacity_(0), head_(0), auto_shrink_floor_(0), alloc_(std::move(other.alloc_)) {
+            reset_buffer();
+            steal(other);
+        }
+
+        ~cvector() {
+            release();
+        }
+
+        // builds the copy first, so *this is unchanged if copying throws
+        // inline elements are then moved over one by one after the old ones are released;
+        // if one of those moves throws, *this is left empty
+        cvector& operator=(const cvector& other) {
+            if (this != &other) {
+                constexpr bool propagate = alloc_traits::propagate_on_container_copy_assignment::value;
+                cvector tmp(other, propagate ? other.alloc_ : alloc_);
+                release();
+                if constexpr (propagate) {
+                    alloc_ = other.alloc_;
+                }
+                steal(tmp);
+            }
+            return *this;
+        }
+
+        // O(1) unless the elements are inline, or the allocators differ and do not propagate, then elements are moved one by one
+        cvector& operator=(cvector&& other) noexcept(
+            (alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value) &&
+            (InlineCapacity == 0 || std::is_nothrow_move_constructible_v<T>)) {
+            if (this != &other) {
+                if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+                    release();
+                    alloc_ = std::move(other.alloc_);
+                    steal(other);
+                } else {
+                    if (alloc_ == other.alloc_) {
+                        release();
+                        steal(other);
+                    } else {
+                        clear();
+                        append(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+                        other.clear();
+                        auto_shrink_floor_ = other.auto_shrink_floor_;
+                    }
+                }
+            }
+            return *this;
+        }
+
+        // allocators are swapped only if they propagate on swap, otherwise they must compare equal
+        void swap(cvector& other) noexcept(InlineCapacity == 0 || std::is_nothrow_move_constructible_v<T>) {
+            if constexpr (alloc_traits::propagate_on_container_swap::value) {
+                std::swap(alloc_, other.alloc_);
+            }
+            if constexpr (InlineCapacity > 0) {
+                if (is_inline() || other.is_inline()) {
+                    // inline elements have to be moved, so pass both buffers through a temporary
+                    cvector tmp(alloc_);
+                    tmp.steal(*this);
+                    steal(other);
+                    other.steal(tmp);
+                    return;
+                }
+            }
+            std::swap(data_, other.data_);
+            std::swap(size_, other.size_);
+            std::swap(capacity_, other.capacity_);
+            std::swap(head_, other.head_);
+            std::swap(auto_shrink_floor_, other.auto_shrink_floor_);
+            generation_.bump();
+            other.generation_.bump();
+            stats_.record_capacity(capacity_ * sizeof(T));
+            other.stats_.record_capacity(other.capacity_ * sizeof(T));
+        }
+
+        friend void swap(cvector& a, cvector& b) noexcept(noexcept(a.swap(b))) {
+            a.swap(b);
+        }
+
+        allocator_type get_allocator() const {
+            return alloc_;
+        }
+
+        Stats& stats() noexcept {
+            return stats_;
+        }
+        const Stats& stats() const noexcept {
+            return stats_;
+        }
+
+        void reserve(size_t new_capacity) {
+            if (new_capacity > capacity_) {
+                grow_capacity(std::bit_ceil(new_capacity));
+            }
+        }
+
+        // reduce capacity to the smallest power of 2 that holds all elements, freeing the buffer if empty
+        // trivially relocatable elements are moved to the front of the buffer and shrunk with realloc
+        // elements that fit in the inline buffer are moved back into it
+        void shrink_to_fit() {
+            size_t new_capacity = std::max(usable_capacity(size_ ? std::bit_ceil(size_) : 0), InlineCapacity);
+            if (new_capacity < capacity_) {
+                shrink_capacity(new_capacity);
+                stats_.record_shrink(capacity_ * sizeof(T));
+            }
+        }
+
+        // enable automatic shrinking on pop: the capacity is halved whenever size drops below a quarter of it
+        // the quarter/half gap keeps a ring that hovers around one size from shrinking and growing repeatedly
+        // capacity is never shrunk below min_capacity
+        void set_auto_shrink(bool enabled, size_t min_capacity = 16) {
+            auto_shrink_floor_ = enabled ? std::bit_ceil(std::max<size_t>(min_capacity, 1)) : 0;
+        }
+
+        void push_back(const T& value) {
+            emplace_back(value);
+        }
+
+        void push_back(T&& value) {
+            emplace_back(std::move(value));
+        }
+
+        void push_front(const T& value) {
+            emplace_front(value);
+        }
+
+        void push_front(T&& value) {
+            emplace_front(std::move(value));
+        }
+
+        // construct a new element in place after the back element
+        // strong guarantee: if growing or constructing throws, the elements are unchanged (only capacity may have grown)
+        template <typename... Args>
+        T& emplace_back(Args&&... args) {
+            if (size_ >= capacity_) {
+                // args may refer to an element of this cvector, so build the value before growing
+                T tmp(std::forward<Args>(args)...);
+                grow_capacity(Growth::next_capacity(capacity_));
+                T* slot = data_ + ((head_ + size_) & (capacity_ - 1));
+                alloc_traits::construct(alloc_, slot, std::move(tmp));
+                if (slot == data_ && size_ > 0) {
+                    stats_.record_wrap();
+                }
+                size_++;
+                return *slot;
+            }
+            T* slot = data_ + ((head_ + size_) & (capacity_ - 1));
+            alloc_traits::construct(alloc_, slot, std::forward<Args>(args)...);
+            if (slot == data_ && size_ > 0) {
+                stats_.record_wrap();
+            }
+            size_++;
+            return *slot;
+        }
+
+        // construct a new element in place before the front element
+        template <typename... Args>
+        T& emplace_front(Args&&... args) {
+            if (size_ >= capacity_) {
+                // args may refer to an element of this cvector, so build the value before growing
+                T tmp(std::forward<Args>(args)...);
+                grow_capacity(Growth::next_capacity(capacity_));
+                size_t new_head = (head_ - 1) & (capacity_ - 1);
+                alloc_traits::construct(alloc_, data_ + new_head, std::move(tmp));
+                if (head_ == 0 && size_ > 0) {
+                    stats_.record_wrap();
+                }
+                head_ = new_head;
+                size_++;
+                return data_[head_];
+            }
+            size_t new_head = (head_ - 1) & (capacity_ - 1);
+            alloc_traits::construct(alloc_, data_ + new_head, std::forward<Args>(args)...);
+            if (head_ == 0 && size_ > 0) {
+                stats_.record_wrap();
+            }
+            head_ = new_head;
+            size_++;
+            return data_[head_];
+        }
+
+        // append [first, last) after the back element
+        // forward ranges reserve once and are copied into at most two contiguous runs
+        // the range must not refer to elements of this cvector
+        template <typename InputIt>
+        void append(InputIt first, InputIt last) {
+            if constexpr (std::forward_iterator<InputIt>) {
+                size_t n = static_cast<size_t>(std::distance(first, last));
+                grow_for(size_ + n);
+                bool wraps = back_wraps(n);
+                construct_range((head_ + size_) & (capacity_ - 1), first, n);
+                if (wraps) {
+                    stats_.record_wrap();
+                }
+                size_ += n;
+            } else {
+                for (; first != last; ++first) {
+                    emplace_back(*first);
+                }
+            }
+        }
+
+        // prepend [first, last) before the front element, keeping the order of the range
+        // the range must not refer to elements of this cvector
+        template <typename InputIt>
+        void prepend(InputIt first, InputIt last) {
+            if constexpr (std::forward_iterator<InputIt>) {
+                prepend_n(first, static_cast<size_t>(std::distance(first, last)));
+            } else {
+                // the length of a single pass range is unknown, so buffer it first
+                // (a move_iterator is never a forward_iterator, so the buffer goes straight to prepend_n)
+                cvector buffer(alloc_);
+                buffer.append(first, last);
+                prepend_n(std::make_move_iterator(buffer.begin()), buffer.size());
+            }
+        }
+
+        // replace the contents with [first, last)
+        template <typename InputIt>
+        void assign(InputIt first, InputIt last) {
+            clear();
+            append(first, last);
+        }
+
+        void pop_back() {
+            if (size_ == 0) {
+                throw std::out_of_range("cvector::pop_back: size is 0");
+            }
+            size_t back = (head_ + size_ - 1) & (capacity_ - 1);
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                alloc_traits::destroy(alloc_, data_ + back);
+            }
+            // the back moves from slot 0 to the end of the buffer
+            if (back == 0 && size_ > 1) {
+                stats_.record_wrap();
+            }
+            size_--;
+            maybe_auto_shrink();
+        }
+
+        void pop_front() {
             if (size_ == 0) {
                 throw std::out_of_range("cvector::pop_front: size is 0");
             }
             if constexpr (!std::is_trivially_destructible_v<T>) {
-                data_[head_].~T();
+                alloc_traits::destroy(alloc_, data_ + head_);
             }
             head_ = (head_ + 1) & (capacity_ - 1);
+            if (head_ == 0 && size_ > 1) {
+                stats_.record_wrap();
+            }
             size_--;
+            maybe_auto_shrink();
         }
 
+        // a mirrored buffer needs no masking: head_ + index stays below 2 * capacity_
         T& operator[](size_t index) {
-            return data_[(head_ + index) & (capacity_ - 1)];
+            check_index(index);
+            if constexpr (mirrored_) {
+                return data_[head_ + index];
+            } else {
+                return data_[(head_ + index) & (capacity_ - 1)];
+            }
         }
         const T& operator[](size_t index) const {
-            return data_[(head_ + index) & (capacity_ - 1)];
+            check_index(index);
+            if constexpr (mirrored_) {
+                return data_[head_ + index];
+            } else {
+                return data_[(head_ + index) & (capacity_ - 1)];
+            }
+        }
+
+        // bounds-checked access, in every build mode
+        T& at(size_t index) {
+            if (index >= size_) {
+                throw std::out_of_range("cvector::at: index out of range");
+            }
+            return (*this)[index];
+        }
+        const T& at(size_t index) const {
+            if (index >= size_) {
+                throw std::out_of_range("cvector::at: index out of range");
+            }
+            return (*this)[index];
         }
 
         T& front() {
+            check_index(0);
             return data_[head_];
         }
         const T& front() const {
+            check_index(0);
             return data_[head_];
         }
 
         T& back() {
-            return data_[(head_ + size_ - 1) & (capacity_ - 1)];
+            return (*this)[size_ - 1];
         }
         const T& back() const {
-            return data_[(head_ + size_ - 1) & (capacity_ - 1)];
+            return (*this)[size_ - 1];
         }
 
         size_t size() const {
@@ -206,12 +1438,62 @@ class cvector {
             return size_ == 0;
         }
         
+        // the logical range [first, last) as at most two contiguous physical runs, in logical order
+        // the second span is empty unless the range crosses the end of the buffer
+        // (which a mirrored buffer never does, its first span runs on into the mirror)
+        std::pair<std::span<T>, std::span<T>> segments(size_t first, size_t last) {
+            size_t start = (head_ + first) & (capacity_ - 1);
+            size_t n = last - first;
+            size_t first_run = mirrored_ ? n : std::min(n, capacity_ - start);
+            return {std::span<T>(data_ + start, first_run), std::span<T>(data_, n - first_run)};
+        }
+        std::pair<std::span<const T>, std::span<const T>> segments(size_t first, size_t last) const {
+            size_t start = (head_ + first) & (capacity_ - 1);
+            size_t n = last - first;
+            size_t first_run = mirrored_ ? n : std::min(n, capacity_ - start);
+            return {std::span<const T>(data_ + start, first_run), std::span<const T>(data_, n - first_run)};
+        }
+
+        // the elements as at most two contiguous physical runs, in logical order
+        // the first span runs from head towards the end of the buffer, the second holds the wrapped part
+        std::pair<std::span<T>, std::span<T>> as_spans() {
+            return segments(0, size_);
+        }
+        std::pair<std::span<const T>, std::span<const T>> as_spans() const {
+            return segments(0, size_);
+        }
+
+        // rearrange the buffer so that all elements form a single contiguous run, capacity is unchanged
+        // iterators are invalidated if the ring was wrapped
+        // a mirrored buffer is already contiguous from head_, so nothing moves
+        std::span<T> linearize() {
+            if (!mirrored_ && head_ + size_ > capacity_) {
+                generation_.bump();
+                if constexpr (is_trivially_relocatable_v<T>) {
+                    unwrap_trivial();
+                } else if (size_ == capacity_) {
+                    std::rotate(data_, data_ + head_, data_ + capacity_);
+                    head_ = 0;
+                } else {
+                    // free slots are uninitialized, so relocate into a buffer of the same capacity
+                    // acquire() cannot hand out the inline buffer while it holds the elements,
+                    // so inline elements go through a heap buffer and back
+                    bool was_inline = is_inline();
+                    grow_capacity_non_trivial(capacity_);
+                    if (was_inline) {
+                        grow_capacity_non_trivial(capacity_);
+                    }
+                }
+            }
+            return std::span<T>(data_ + head_, size_);
+        }
+
         void clear() {
             // Destroy all objects for non-trivially destructible types
             if constexpr (!std::is_trivially_destructible_v<T>) {
                 for (size_t i = 0; i < size_; ++i) {
                     size_t index = (head_ + i) & (capacity_ - 1);
-                    data_[index].~T();
+                    alloc_traits::destroy(alloc_, data_ + index);
                 }
             }
             size_ = 0;
@@ -230,7 +1512,22 @@ class cvector {
         class iterator {
         private:
             cvector* container_;
-            size_t physical_index_;  // Physical position in the buffer (remains stable)
+            // Physical position in the buffer (remains stable), counted modulo 2 * capacity
+            // so that end() of a full ring is distinct from begin()
+            size_t physical_index_;
+            // buffer generation the iterator was made for, only tracked in hardened mode
+            [[no_unique_address]] generation_type generation_;
+            
+            void check_dereference() const {
+                if constexpr (cvector_hardened) {
+                    if (generation_.value() != container_->generation_.value()) {
+                        hardening_failure("iterator used after the buffer was reallocated");
+                    }
+                    if (static_cast<size_t>(logical_position()) >= container_->size_) {
+                        hardening_failure("iterator dereferenced outside [begin, end)");
+                    }
+                }
+            }
             
         public:
             // Iterator traits
@@ -240,62 +1537,72 @@ class cvector {
             using pointer = T*;
             using reference = T&;
             
+            // a singular iterator, only good for assigning to (std::forward_iterator needs one)
+            iterator() noexcept : container_(nullptr), physical_index_(0), generation_() {}
+            
             iterator(cvector* container, size_t physical_index) 
-                : container_(container), physical_index_(physical_index) {}
+                : container_(container), physical_index_(physical_index), generation_(container->generation_) {}
             
             // Convert physical index to logical position (for distance calculations)
             difference_type logical_position() const {
                 // Calculate logical distance from head
-                if (physical_index_ >= container_->head_) {
-                    return static_cast<difference_type>(physical_index_ - container_->head_);
-                } else {
-                    // Wrapped around case
-                    return static_cast<difference_type>(container_->capacity_ - container_->head_ + physical_index_);
+                // positions past capacity can only come from a head that moved since the iterator was made
+                size_t position = (physical_index_ - container_->head_) & (2 * container_->capacity_ - 1);
+                if (position > container_->capacity_) {
+                    position -= container_->capacity_;
                 }
+                return static_cast<difference_type>(position);
             }
             
             // Dereference
             reference operator*() const { 
-                return container_->data_[physical_index_]; 
+                check_dereference();
+                return container_->data_[physical_index_ & (container_->capacity_ - 1)]; 
             }
             pointer operator->() const { 
-                return &container_->data_[physical_index_]; 
+                check_dereference();
+                return &container_->data_[physical_index_ & (container_->capacity_ - 1)]; 
             }
             
             // Increment/Decrement (physical, with wrapping)
             iterator& operator++() { 
-                physical_index_ = (physical_index_ + 1) & (container_->capacity_ - 1); 
+                physical_index_ = (physical_index_ + 1) & (2 * container_->capacity_ - 1); 
                 return *this; 
             }
             iterator operator++(int) { 
                 iterator tmp = *this; 
-                physical_index_ = (physical_index_ + 1) & (container_->capacity_ - 1); 
+                physical_index_ = (physical_index_ + 1) & (2 * container_->capacity_ - 1); 
                 return tmp; 
             }
             iterator& operator--() { 
-                physical_index_ = (physical_index_ - 1) & (container_->capacity_ - 1); 
+                physical_index_ = (physical_index_ - 1) & (2 * container_->capacity_ - 1); 
                 return *this; 
             }
             iterator operator--(int) { 
                 iterator tmp = *this; 
-                physical_index_ = (physical_index_ - 1) & (container_->capacity_ - 1); 
+                physical_index_ = (physical_index_ - 1) & (2 * container_->capacity_ - 1); 
                 return tmp; 
             }
             
             // Random access
             iterator& operator+=(difference_type n) { 
-                physical_index_ = (physical_index_ + n) & (container_->capacity_ - 1);
+                physical_index_ = (physical_index_ + n) & (2 * container_->capacity_ - 1);
                 return *this; 
             }
             iterator& operator-=(difference_type n) { 
-                physical_index_ = (physical_index_ - n) & (container_->capacity_ - 1);
+                physical_index_ = (physical_index_ - n) & (2 * container_->capacity_ - 1);
                 return *this; 
             }
             iterator operator+(difference_type n) const { 
-                return iterator(container_, (physical_index_ + n) & (container_->capacity_ - 1)); 
+                iterator tmp = *this;
+                return tmp += n; 
+            }
+            friend iterator operator+(difference_type n, const iterator& it) {
+                return it + n;
             }
             iterator operator-(difference_type n) const { 
-                return iterator(container_, (physical_index_ - n) & (container_->capacity_ - 1)); 
+                iterator tmp = *this;
+                return tmp -= n; 
             }
             
             // Comparison
@@ -324,8 +1631,12 @@ class cvector {
             
             // Array access
             reference operator[](difference_type n) const {
-                size_t target_physical = (physical_index_ + n) & (container_->capacity_ - 1);
-                return container_->data_[target_physical];
+                return *(*this + n);
+            }
+            
+            // Segmented iteration: the raw runs covering [*this, last)
+            std::pair<std::span<T>, std::span<T>> segments(const iterator& last) const {
+                return container_->segments(logical_position(), last.logical_position());
             }
             
             // Friend access for const_iterator
@@ -336,6 +1647,18 @@ class cvector {
         private:
             const cvector* container_;
             size_t physical_index_;
+            [[no_unique_address]] generation_type generation_;
+            
+            void check_dereference() const {
+                if constexpr (cvector_hardened) {
+                    if (generation_.value() != container_->generation_.value()) {
+                        hardening_failure("iterator used after the buffer was reallocated");
+                    }
+                    if (static_cast<size_t>(logical_position()) >= container_->size_) {
+                        hardening_failure("iterator dereferenced outside [begin, end)");
+                    }
+                }
+            }
             
         public:
             using iterator_category = std::random_access_iterator_tag;
@@ -344,56 +1667,69 @@ class cvector {
             using pointer = const T*;
             using reference = const T&;
             
+            const_iterator() noexcept : container_(nullptr), physical_index_(0), generation_() {}
+            
             const_iterator(const cvector* container, size_t physical_index) 
-                : container_(container), physical_index_(physical_index) {}
+                : container_(container), physical_index_(physical_index), generation_(container->generation_) {}
                 
             // Convert from non-const iterator
             const_iterator(const iterator& it) 
-                : container_(it.container_), physical_index_(it.physical_index_) {}
+                : container_(it.container_), physical_index_(it.physical_index_), generation_(it.generation_) {}
             
             difference_type logical_position() const {
-                if (physical_index_ >= container_->head_) {
-                    return static_cast<difference_type>(physical_index_ - container_->head_);
-                } else {
-                    return static_cast<difference_type>(container_->capacity_ - container_->head_ + physical_index_);
+                size_t position = (physical_index_ - container_->head_) & (2 * container_->capacity_ - 1);
+                if (position > container_->capacity_) {
+                    position -= container_->capacity_;
                 }
+                return static_cast<difference_type>(position);
             }
             
-            reference operator*() const { return container_->data_[physical_index_]; }
-            pointer operator->() const { return &container_->data_[physical_index_]; }
+            reference operator*() const {
+                check_dereference();
+                return container_->data_[physical_index_ & (container_->capacity_ - 1)];
+            }
+            pointer operator->() const {
+                check_dereference();
+                return &container_->data_[physical_index_ & (container_->capacity_ - 1)];
+            }
             
             const_iterator& operator++() { 
-                physical_index_ = (physical_index_ + 1) & (container_->capacity_ - 1); 
+                physical_index_ = (physical_index_ + 1) & (2 * container_->capacity_ - 1); 
                 return *this; 
             }
             const_iterator operator++(int) { 
                 const_iterator tmp = *this; 
-                physical_index_ = (physical_index_ + 1) & (container_->capacity_ - 1); 
+                physical_index_ = (physical_index_ + 1) & (2 * container_->capacity_ - 1); 
                 return tmp; 
             }
             const_iterator& operator--() { 
-                physical_index_ = (physical_index_ - 1) & (container_->capacity_ - 1); 
+                physical_index_ = (physical_index_ - 1) & (2 * container_->capacity_ - 1); 
                 return *this; 
             }
             const_iterator operator--(int) { 
                 const_iterator tmp = *this; 
-                physical_index_ = (physical_index_ - 1) & (container_->capacity_ - 1); 
+                physical_index_ = (physical_index_ - 1) & (2 * container_->capacity_ - 1); 
                 return tmp; 
             }
             
             const_iterator& operator+=(difference_type n) { 
-                physical_index_ = (physical_index_ + n) & (container_->capacity_ - 1);
+                physical_index_ = (physical_index_ + n) & (2 * container_->capacity_ - 1);
                 return *this; 
             }
             const_iterator& operator-=(difference_type n) { 
-                physical_index_ = (physical_index_ - n) & (container_->capacity_ - 1);
+                physical_index_ = (physical_index_ - n) & (2 * container_->capacity_ - 1);
                 return *this; 
             }
             const_iterator operator+(difference_type n) const { 
-                return const_iterator(container_, (physical_index_ + n) & (container_->capacity_ - 1)); 
+                const_iterator tmp = *this;
+                return tmp += n; 
+            }
+            friend const_iterator operator+(difference_type n, const const_iterator& it) {
+                return it + n;
             }
             const_iterator operator-(difference_type n) const { 
-                return const_iterator(container_, (physical_index_ - n) & (container_->capacity_ - 1)); 
+                const_iterator tmp = *this;
+                return tmp -= n; 
             }
             
             bool operator==(const const_iterator& other) const { 
@@ -418,8 +1754,11 @@ class cvector {
             }
             
             reference operator[](difference_type n) const {
-                size_t target_physical = (physical_index_ + n) & (container_->capacity_ - 1);
-                return container_->data_[target_physical];
+                return *(*this + n);
+            }
+            
+            std::pair<std::span<const T>, std::span<const T>> segments(const const_iterator& last) const {
+                return container_->segments(logical_position(), last.logical_position());
             }
         };
 
@@ -428,9 +1767,9 @@ class cvector {
         const_iterator begin() const { return const_iterator(this, head_); }
         const_iterator cbegin() const { return const_iterator(this, head_); }
         
-        iterator end() { return iterator(this, (head_ + size_) & (capacity_ - 1)); }
-        const_iterator end() const { return const_iterator(this, (head_ + size_) & (capacity_ - 1)); }
-        const_iterator cend() const { return const_iterator(this, (head_ + size_) & (capacity_ - 1)); }
+        iterator end() { return iterator(this, head_ + size_); }
+        const_iterator end() const { return const_iterator(this, head_ + size_); }
+        const_iterator cend() const { return const_iterator(this, head_ + size_); }
         
         // Reverse iterators
         std::reverse_iterator<iterator> rbegin() { return std::reverse_iterator<iterator>(end()); }
@@ -440,6 +1779,1335 @@ class cvector {
         std::reverse_iterator<iterator> rend() { return std::reverse_iterator<iterator>(begin()); }
         std::reverse_iterator<const_iterator> rend() const { return std::reverse_iterator<const_iterator>(begin()); }
         std::reverse_iterator<const_iterator> crend() const { return std::reverse_iterator<const_iterator>(begin()); }
+
+        // insert [first, last) before pos, returns an iterator to the first inserted element
+        // room is made once, then the elements on the shorter side of pos are shifted to open a gap for the range
+        // the range must not refer to elements of this cvector
+        template <typename InputIt>
+        iterator insert(const_iterator pos, InputIt first, InputIt last) {
+            size_t index = static_cast<size_t>(pos - cbegin());
+            if constexpr (std::forward_iterator<InputIt>) {
+                insert_n(index, first, static_cast<size_t>(std::distance(first, last)));
+            } else {
+                // the length of a single pass range is unknown, so buffer it first
+                cvector buffer(alloc_);
+                buffer.append(first, last);
+                insert_n(index, std::make_move_iterator(buffer.begin()), buffer.size());
+            }
+            return begin() + index;
+        }
+
+        // construct an element in place before pos, returns an iterator to it
+        // the elements on the shorter side of pos are shifted by one, towards head or towards tail
+        // at the ends this is emplace_back/emplace_front and nothing changes if it throws; in the middle a throwing
+        // move assignment leaves every element valid but some of them shifted, like std::deque
+        template <typename... Args>
+        iterator emplace(const_iterator pos, Args&&... args) {
+            size_t index = static_cast<size_t>(pos - cbegin());
+            if (index == size_) {
+                emplace_back(std::forward<Args>(args)...);
+                return begin() + index;
+            }
+            if (index == 0) {
+                emplace_front(std::forward<Args>(args)...);
+                return begin();
+            }
+            // args may refer to an element that is about to move
+            T value(std::forward<Args>(args)...);
+            // the shifted elements leave a gap of raw bytes, so the final move into it must not throw
+            if constexpr (is_trivially_relocatable_v<T> && std::is_nothrow_move_constructible_v<T>) {
+                grow_for(size_ + 1);
+                if (index < size_ / 2) {
+                    head_ = (head_ - 1) & (capacity_ - 1);
+                    size_++;
+                    move_elements_trivial(1, 0, index);
+                } else {
+                    size_++;
+                    move_elements_trivial(index, index + 1, size_ - 1 - index);
+                }
+                alloc_traits::construct(alloc_, &(*this)[index], std::move(value));
+            } else if (index < size_ / 2) {
+                emplace_front(std::move(front()));
+                std::move(begin() + 2, begin() + 1 + index, begin() + 1);
+                (*this)[index] = std::move(value);
+            } else {
+                emplace_back(std::move(back()));
+                std::move_backward(begin() + index, end() - 2, end() - 1);
+                (*this)[index] = std::move(value);
+            }
+            return begin() + index;
+        }
+
+        iterator insert(const_iterator pos, const T& value) {
+            return emplace(pos, value);
+        }
+
+        iterator insert(const_iterator pos, T&& value) {
+            return emplace(pos, std::move(value));
+        }
+
+        // remove [first, last), returns an iterator to the element that followed the removed ones
+        // the elements on the shorter side of the gap are shifted to close it
+        iterator erase(const_iterator first, const_iterator last) {
+            size_t index = static_cast<size_t>(first - cbegin());
+            size_t n = static_cast<size_t>(last - first);
+            if (n == 0) {
+                return begin() + index;
+            }
+            size_t after = size_ - index - n;
+            // relocatable elements are destroyed first, then the gap is closed with raw moves
+            if constexpr (is_trivially_relocatable_v<T> && !std::is_trivially_destructible_v<T>) {
+                for (size_t i = index; i < index + n; ++i) {
+                    alloc_traits::destroy(alloc_, &(*this)[i]);
+                }
+            }
+            if (index < after) {
+                // shift the front elements towards tail, the first n slots become free
+                if constexpr (is_trivially_relocatable_v<T>) {
+                    move_elements_trivial(0, n, index);
+                } else {
+                    std::move_backward(begin(), begin() + index, begin() + index + n);
+                    for (size_t i = 0; i < n; ++i) {
+                        alloc_traits::destroy(alloc_, &(*this)[i]);
+                    }
+                }
+                head_ = (head_ + n) & (capacity_ - 1);
+            } else {
+                // shift the back elements towards head, the last n slots become free
+                if constexpr (is_trivially_relocatable_v<T>) {
+                    move_elements_trivial(index + n, index, after);
+                } else {
+                    std::move(begin() + index + n, end(), begin() + index);
+                    for (size_t i = size_ - n; i < size_; ++i) {
+                        alloc_traits::destroy(alloc_, &(*this)[i]);
+                    }
+                }
+            }
+            size_ -= n;
+            maybe_auto_shrink();
+            return begin() + index;
+        }
+
+        iterator erase(const_iterator pos) {
+            return erase(pos, pos + 1);
+        }
+};
+
+// a heap-only cvector holds no pointer into itself
+template <typename T, size_t Alignment, typename Growth>
+struct is_trivially_relocatable<cvector<T, malloc_allocator<T, Alignment>, 0, Growth, no_stats>> : std::true_type {};
+
+// cvector that keeps up to N elements inline before spilling to the heap
+// moving or swapping one that is still inline moves its elements, so pointers and iterators into it are invalidated
+template <typename T, size_t N, typename Allocator = malloc_allocator<T>, typename Growth = doubling_growth<>>
+using small_cvector = cvector<T, Allocator, N, Growth>;
+
+// cvector whose buffer always starts on an Alignment boundary (a cache line by default), through every growth and shrink
+template <typename T, size_t Alignment = 64, typename Growth = doubling_growth<>>
+using aligned_cvector = cvector<T, malloc_allocator<T, Alignment>, 0, Growth>;
+
+// window aggregates: policies that windowed_cvector updates as elements enter and leave its window
+// an aggregate provides push(value) for the element appended at the back, pop(value) for the element removed from
+// the front (always the oldest one) and clear(); windowed_cvector calls reserve(n) as well if it is provided
+
+// running sum, O(1) per update
+template <typename T>
+class window_sum {
+    private:
+        T sum_{};
+        size_t count_ = 0;
+
+    public:
+        void push(const T& value) {
+            sum_ += value;
+            ++count_;
+        }
+        void pop(const T& value) {
+            sum_ -= value;
+            --count_;
+        }
+        void clear() {
+            sum_ = T{};
+            count_ = 0;
+        }
+
+        T sum() const {
+            return sum_;
+        }
+        // 0 for an empty window
+        double mean() const {
+            return count_ ? static_cast<double>(sum_) / static_cast<double>(count_) : 0.0;
+        }
+};
+
+// mean and variance, O(1) per update
+// Welford's update is run forwards on push and backwards on pop, which stays accurate where sum of squares would not;
+// rounding still accumulates over very long streams of floating point samples
+template <typename T>
+class window_moments {
+    private:
+        size_t count_ = 0;
+        double mean_ = 0.0;
+        // sum of squared differences from the mean
+        double m2_ = 0.0;
+
+    public:
+        void push(const T& value) {
+            double x = static_cast<double>(value);
+            ++count_;
+            double delta = x - mean_;
+            mean_ += delta / static_cast<double>(count_);
+            m2_ += delta * (x - mean_);
+        }
+        void pop(const T& value) {
+            if (count_ <= 1) {
+                clear();
+                return;
+            }
+            double x = static_cast<double>(value);
+            double old_mean = mean_;
+            --count_;
+            mean_ = (old_mean * static_cast<double>(count_ + 1) - x) / static_cast<double>(count_);
+            m2_ = std::max(m2_ - (x - old_mean) * (x - mean_), 0.0);
+        }
+        void clear() {
+            count_ = 0;
+            mean_ = 0.0;
+            m2_ = 0.0;
+        }
+
+        // 0 for an empty window
+        double mean() const {
+            return mean_;
+        }
+        // population variance, 0 for an empty window
+        double variance() const {
+            return count_ ? m2_ / static_cast<double>(count_) : 0.0;
+        }
+};
+
+// smallest element by Compare (largest with std::greater<>), O(1) amortized per update
+// keeps a monotonic queue of the elements that can still become the extreme: every element that is not better than
+// a newer one is dropped, so the front of the queue is the answer and each element is pushed and popped at most once
+template <typename T, typename Compare = std::less<>>
+class window_extreme {
+    private:
+        struct candidate {
+            T value;
+            // position of the element in the stream, to recognize it when it leaves the window
+            uint64_t sequence;
+        };
+
+        cvector<candidate> candidates_;
+        uint64_t pushed_ = 0;
+        uint64_t popped_ = 0;
+        [[no_unique_address]] Compare compare_;
+
+    public:
+        void push(const T& value) {
+            while (!candidates_.empty() && !compare_(candidates_.back().value, value)) {
+                candidates_.pop_back();
+            }
+            candidates_.push_back(candidate{value, pushed_});
+            ++pushed_;
+        }
+        void pop(const T&) {
+            if (!candidates_.empty() && candidates_.front().sequence == popped_) {
+                candidates_.pop_front();
+            }
+            ++popped_;
+        }
+        void clear() {
+            candidates_.clear();
+            pushed_ = 0;
+            popped_ = 0;
+        }
+        void reserve(size_t n) {
+            candidates_.reserve(n);
+        }
+
+        const T& value() const {
+            if (candidates_.empty()) {
+                throw std::out_of_range("window_extreme::value: window is empty");
+            }
+            return candidates_.front().value;
+        }
 };
 
+template <typename T>
+using window_min = window_extreme<T, std::less<>>;
+
+template <typename T>
+using window_max = window_extreme<T, std::greater<>>;
+
+// sum, mean, variance, min and max together
+template <typename T>
+class window_stats {
+    private:
+        window_sum<T> sum_;
+        window_moments<T> moments_;
+        window_min<T> min_;
+        window_max<T> max_;
+
+    public:
+        void push(const T& value) {
+            sum_.push(value);
+            moments_.push(value);
+            min_.push(value);
+            max_.push(value);
+        }
+        void pop(const T& value) {
+            sum_.pop(value);
+            moments_.pop(value);
+            min_.pop(value);
+            max_.pop(value);
+        }
+        void clear() {
+            sum_.clear();
+            moments_.clear();
+            min_.clear();
+            max_.clear();
+        }
+        void reserve(size_t n) {
+            min_.reserve(n);
+            max_.reserve(n);
+        }
+
+        T sum() const {
+            return sum_.sum();
+        }
+        double mean() const {
+            return moments_.mean();
+        }
+        double variance() const {
+            return moments_.variance();
+        }
+        const T& min() const {
+            return min_.value();
+        }
+        const T& max() const {
+            return max_.value();
+        }
+};
+
+// cvector used as a sliding window, with aggregates that are kept up to date on every push and pop
+// constructed with a window length, push_back drops the oldest element once the window is full;
+// with window 0 the window is unbounded and the caller pops elements itself
+// the elements are read-only, so the aggregates always describe them
+template <typename T, typename Agg = window_stats<T>>
+class windowed_cvector {
+    private:
+        cvector<T> data_;
+        Agg agg_;
+        size_t window_;
+
+        // recompute the aggregates from the elements after an update failed partway through them
+        // if that fails as well the window is emptied, so the aggregates still describe the elements
+        void rebuild() noexcept {
+            agg_.clear();
+            try {
+                for (const T& value : data_) {
+                    agg_.push(value);
+                }
+            } catch (...) {
+                agg_.clear();
+                data_.clear();
+            }
+        }
+
+    public:
+        using value_type = T;
+        using const_iterator = typename cvector<T>::const_iterator;
+
+        // buffers for a bounded window are allocated up front, so pushing never reallocates
+        explicit windowed_cvector(size_t window = 0) : window_(window) {
+            if (window_ > 0) {
+                data_.reserve(window_);
+                if constexpr (requires { agg_.reserve(window_); }) {
+                    agg_.reserve(window_);
+                }
+            }
+        }
+
+        // if the aggregate cannot take the new element it is removed again and the aggregates are rebuilt from the
+        // remaining elements; the evicted oldest element stays evicted
+        void push_back(const T& value) {
+            if (window_ > 0 && data_.size() == window_) {
+                pop_front();
+            }
+            data_.push_back(value);
+            try {
+                agg_.push(data_.back());
+            } catch (...) {
+                data_.pop_back();
+                rebuild();
+                throw;
+            }
+        }
+
+        void pop_front() {
+            if (data_.empty()) {
+                throw std::out_of_range("windowed_cvector::pop_front: size is 0");
+            }
+            agg_.pop(data_.front());
+            data_.pop_front();
+        }
+
+        void clear() {
+            data_.clear();
+            agg_.clear();
+        }
+
+        const Agg& aggregates() const {
+            return agg_;
+        }
+
+        const T& operator[](size_t index) const {
+            return data_[index];
+        }
+        const T& at(size_t index) const {
+            return data_.at(index);
+        }
+        const T& front() const {
+            return data_.front();
+        }
+        const T& back() const {
+            return data_.back();
+        }
+
+        size_t size() const {
+            return data_.size();
+        }
+        bool empty() const {
+            return data_.empty();
+        }
+        bool full() const {
+            return window_ > 0 && data_.size() == window_;
+        }
+        size_t window() const {
+            return window_;
+        }
+
+        const_iterator begin() const { return data_.begin(); }
+        const_iterator end() const { return data_.end(); }
+        const_iterator cbegin() const { return data_.cbegin(); }
+        const_iterator cend() const { return data_.cend(); }
+};
+
+// single-producer/single-consumer lock-free ring buffer
+// uses the same power of 2 capacity and masking as cvector, but the capacity is fixed
+// head_ and tail_ count pushes/pops without wrapping and are masked on access
+// each index lives on its own cache line together with the other side's index as last seen,
+// so the producer and consumer only touch each other's line when the cached value runs out
+template <typename T>
+class spsc_ring {
+    private:
+        static constexpr size_t cache_line_size_ = 64;
+
+        T* const data_;
+        const size_t capacity_;
+
+        // consumer side
+        alignas(cache_line_size_) std::atomic<size_t> head_;
+        size_t cached_tail_;
+
+        // producer side
+        alignas(cache_line_size_) std::atomic<size_t> tail_;
+        size_t cached_head_;
+
+        static T* allocate(size_t capacity) {
+            T* data = static_cast<T*>(std::aligned_alloc(alignof(T), capacity * sizeof(T)));
+            if (!data) {
+                throw std::bad_alloc();
+            }
+            return data;
+        }
+
+        // number of free slots as seen by the producer, refreshing the cached head only if needed
+        size_t free_slots(size_t tail, size_t wanted) {
+            size_t free = capacity_ - (tail - cached_head_);
+            if (free < wanted) {
+                cached_head_ = head_.load(std::memory_order_acquire);
+                free = capacity_ - (tail - cached_head_);
+            }
+            return free;
+        }
+
+        // number of filled slots as seen by the consumer, refreshing the cached tail only if needed
+        size_t filled_slots(size_t head, size_t wanted) {
+            size_t filled = cached_tail_ - head;
+            if (filled < wanted) {
+                cached_tail_ = tail_.load(std::memory_order_acquire);
+                filled = cached_tail_ - head;
+            }
+            return filled;
+        }
+
+    public:
+        // capacity is rounded up to a power of 2
+        explicit spsc_ring(size_t capacity)
+            : data_(allocate(std::bit_ceil(std::max<size_t>(capacity, 1)))),
+              capacity_(std::bit_ceil(std::max<size_t>(capacity, 1))),
+              head_(0), cached_tail_(0), tail_(0), cached_head_(0) {}
+
+        spsc_ring(const spsc_ring&) = delete;
+        spsc_ring& operator=(const spsc_ring&) = delete;
+
+        ~spsc_ring() {
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                size_t tail = tail_.load(std::memory_order_relaxed);
+                for (size_t i = head_.load(std::memory_order_relaxed); i != tail; ++i) {
+                    data_[i & (capacity_ - 1)].~T();
+                }
+            }
+            std::free(data_);
+        }
+
+        // producer: construct an element in place, returns false if the ring is full
+        template <typename... Args>
+        bool try_emplace(Args&&... args) {
+            size_t tail = tail_.load(std::memory_order_relaxed);
+            if (free_slots(tail, 1) == 0) {
+                return false;
+            }
+            new (data_ + (tail & (capacity_ - 1))) T(std::forward<Args>(args)...);
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool try_push(const T& value) {
+            return try_emplace(value);
+        }
+
+        bool try_push(T&& value) {
+            return try_emplace(std::move(value));
+        }
+
+        // producer: push up to n elements from first, returns the number pushed
+        // all pushed elements are published to the consumer at once
+        // if constructing an element throws, nothing is pushed: the elements built so far are destroyed
+        template <typename InputIt>
+        size_t push_n(InputIt first, size_t n) {
+            size_t tail = tail_.load(std::memory_order_relaxed);
+            n = std::min(n, free_slots(tail, n));
+            size_t i = 0;
+            try {
+                for (; i < n; ++i, ++first) {
+                    new (data_ + ((tail + i) & (capacity_ - 1))) T(*first);
+                }
+            } catch (...) {
+                if constexpr (!std::is_trivially_destructible_v<T>) {
+                    while (i > 0) {
+                        --i;
+                        data_[(tail + i) & (capacity_ - 1)].~T();
+                    }
+                }
+                throw;
+            }
+            tail_.store(tail + n, std::memory_order_release);
+            return n;
+        }
+
+        // consumer: move the front element into out, returns false if the ring is empty
+        bool try_pop(T& out) {
+            size_t head = head_.load(std::memory_order_relaxed);
+            if (filled_slots(head, 1) == 0) {
+                return false;
+            }
+            T& slot = data_[head & (capacity_ - 1)];
+            out = std::move(slot);
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                slot.~T();
+            }
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // consumer: move up to n elements into out, returns the number popped
+        // if writing to out throws, the elements already written are popped and the rest stay in the ring
+        template <typename OutputIt>
+        size_t pop_n(OutputIt out, size_t n) {
+            size_t head = head_.load(std::memory_order_relaxed);
+            n = std::min(n, filled_slots(head, n));
+            size_t i = 0;
+            try {
+                for (; i < n; ++i, ++out) {
+                    T& slot = data_[(head + i) & (capacity_ - 1)];
+                    *out = std::move(slot);
+                    if constexpr (!std::is_trivially_destructible_v<T>) {
+                        slot.~T();
+                    }
+                }
+            } catch (...) {
+                head_.store(head + i, std::memory_order_release);
+                throw;
+            }
+            head_.store(head + n, std::memory_order_release);
+            return n;
+        }
+
+        // approximate when called concurrently with the other side
+        size_t size() const {
+            // load head first, tail can only have moved further ahead
+            size_t head = head_.load(std::memory_order_acquire);
+            return tail_.load(std::memory_order_acquire) - head;
+        }
+        size_t capacity() const {
+            return capacity_;
+        }
+        bool empty() const {
+            return size() == 0;
+        }
+};
+
+// bounded multi-producer/multi-consumer lock-free queue (Vyukov)
+// slots use the same power of 2 ring layout as cvector and each carries a sequence number:
+//   sequence == pos           slot is free for the producer that claims position pos
+//   sequence == pos + 1       slot holds the element pushed at position pos
+//   sequence == pos + capacity slot was popped and is free for the next lap
+// producers and consumers claim positions with a CAS on their own cache-line padded counter
+// nothing may throw between claiming a position and publishing its sequence, or the slot stays stuck forever:
+// elements that can't be constructed in place without throwing are built before claiming and moved in,
+// so T must be nothrow move constructible and nothrow move assignable
+template <typename T>
+class mpmc_queue {
+    private:
+        static constexpr size_t cache_line_size_ = 64;
+
+        struct slot {
+            std::atomic<size_t> sequence;
+            alignas(T) unsigned char storage[sizeof(T)];
+
+            T* value() {
+                return std::launder(reinterpret_cast<T*>(storage));
+            }
+        };
+
+        slot* const slots_;
+        const size_t capacity_;
+
+        alignas(cache_line_size_) std::atomic<size_t> enqueue_pos_;
+        alignas(cache_line_size_) std::atomic<size_t> dequeue_pos_;
+
+        static slot* allocate(size_t capacity) {
+            slot* slots = static_cast<slot*>(std::aligned_alloc(alignof(slot), capacity * sizeof(slot)));
+            if (!slots) {
+                throw std::bad_alloc();
+            }
+            for (size_t i = 0; i < capacity; ++i) {
+                new (&slots[i].sequence) std::atomic<size_t>(i);
+            }
+            return slots;
+        }
+
+        // spin briefly, then give the time slice away
+        static void backoff(unsigned& attempt) {
+            if (++attempt < 64) {
+                return;
+            }
+            std::this_thread::yield();
+        }
+
+    public:
+        // capacity is rounded up to a power of 2 (at least 2)
+        explicit mpmc_queue(size_t capacity)
+            : slots_(allocate(std::bit_ceil(std::max<size_t>(capacity, 2)))),
+              capacity_(std::bit_ceil(std::max<size_t>(capacity, 2))),
+              enqueue_pos_(0), dequeue_pos_(0) {}
+
+        mpmc_queue(const mpmc_queue&) = delete;
+        mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+        ~mpmc_queue() {
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                size_t tail = enqueue_pos_.load(std::memory_order_relaxed);
+                for (size_t i = dequeue_pos_.load(std::memory_order_relaxed); i != tail; ++i) {
+                    slots_[i & (capacity_ - 1)].value()->~T();
+                }
+            }
+            std::free(slots_);
+        }
+
+        // construct an element in place, returns false if the queue is full
+        // if that constructor can throw, the element is constructed first and discarded when the queue is full
+        template <typename... Args>
+        bool try_emplace(Args&&... args) {
+            if constexpr (!std::is_nothrow_constructible_v<T, Args&&...>) {
+                return try_emplace(T(std::forward<Args>(args)...));
+            }
+            static_assert(std::is_nothrow_move_constructible_v<T>, "mpmc_queue: T must be nothrow move constructible");
+            size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+            slot* s;
+            for (;;) {
+                s = &slots_[pos & (capacity_ - 1)];
+                size_t sequence = s->sequence.load(std::memory_order_acquire);
+                std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence - pos);
+                if (diff == 0) {
+                    if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = enqueue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+            new (s->storage) T(std::forward<Args>(args)...);
+            s->sequence.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+
+        bool try_push(const T& value) {
+            return try_emplace(value);
+        }
+
+        bool try_push(T&& value) {
+            return try_emplace(std::move(value));
+        }
+
+        // move the oldest element into out, returns false if the queue is empty
+        bool try_pop(T& out) {
+            static_assert(std::is_nothrow_move_assignable_v<T>, "mpmc_queue: T must be nothrow move assignable");
+            size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+            slot* s;
+            for (;;) {
+                s = &slots_[pos & (capacity_ - 1)];
+                size_t sequence = s->sequence.load(std::memory_order_acquire);
+                std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence - (pos + 1));
+                if (diff == 0) {
+                    if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        break;
+                    }
+                } else if (diff < 0) {
+                    return false;
+                } else {
+                    pos = dequeue_pos_.load(std::memory_order_relaxed);
+                }
+            }
+            T* value = s->value();
+            out = std::move(*value);
+            value->~T();
+            s->sequence.store(pos + capacity_, std::memory_order_release);
+            return true;
+        }
+
+        // blocking variants wait until a slot or an element is available
+        void push(const T& value) {
+            if constexpr (!std::is_nothrow_copy_constructible_v<T>) {
+                // copy once up front instead of on every attempt
+                push(T(value));
+                return;
+            }
+            for (unsigned attempt = 0; !try_emplace(value); backoff(attempt)) {}
+        }
+
+        void push(T&& value) {
+            for (unsigned attempt = 0; !try_emplace(std::move(value)); backoff(attempt)) {}
+        }
+
+        T pop() {
+            T out;
+            for (unsigned attempt = 0; !try_pop(out); backoff(attempt)) {}
+            return out;
+        }
+
+        // timed variants give up after timeout, returning false
+        template <typename Rep, typename Period>
+        bool try_push_for(const T& value, std::chrono::duration<Rep, Period> timeout) {
+            if constexpr (!std::is_nothrow_copy_constructible_v<T>) {
+                return try_push_for(T(value), timeout);
+            }
+            auto deadline = std::chrono::steady_clock::now() + timeout;
+            for (unsigned attempt = 0; !try_emplace(value); backoff(attempt)) {
+                if (std::chrono::steady_clock::now() >= deadline) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        template <typename Rep, typename Period>
+        bool try_push_for(T&& value, std::chrono::duration<Rep, Period> timeout) {
+            auto deadline = std::chrono::steady_clock::now() + timeout;
+            for (unsigned attempt = 0; !try_emplace(std::move(value)); backoff(attempt)) {
+                if (std::chrono::steady_clock::now() >= deadline) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        template <typename Rep, typename Period>
+        bool try_pop_for(T& out, std::chrono::duration<Rep, Period> timeout) {
+            auto deadline = std::chrono::steady_clock::now() + timeout;
+            for (unsigned attempt = 0; !try_pop(out); backoff(attempt)) {
+                if (std::chrono::steady_clock::now() >= deadline) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // pop up to n elements into out without waiting, returns the number popped
+        template <typename OutputIt>
+        size_t pop_n(OutputIt out, size_t n) {
+            size_t popped = 0;
+            T value;
+            while (popped < n && try_pop(value)) {
+                *out = std::move(value);
+                ++out;
+                ++popped;
+            }
+            return popped;
+        }
+
+        // approximate when called concurrently
+        size_t size() const {
+            size_t head = dequeue_pos_.load(std::memory_order_acquire);
+            size_t tail = enqueue_pos_.load(std::memory_order_acquire);
+            return tail > head ? tail - head : 0;
+        }
+        size_t capacity() const {
+            return capacity_;
+        }
+        bool empty() const {
+            return size() == 0;
+        }
+};
+
+#if __has_include(<sys/mman.h>)
+// persistent ring of trivially copyable elements, stored in a memory-mapped file
+// the file is a header page followed by the elements, so reopening it restores the ring without reading anything
+// the element pages are mapped twice, back to back (see mirrored_allocator), so the elements are always
+// one contiguous run and iterators are plain pointers
+// head and tail count pops and pushes without wrapping (like spsc_ring) and are masked on access,
+// so every operation publishes its result with a single store and a crashed process never leaves the header
+// inconsistent; flush() makes the contents durable against power loss as well
+template <typename T>
+class mapped_cvector {
+    static_assert(std::is_trivially_copyable_v<T>, "mapped_cvector stores elements as raw bytes");
+
+    private:
+        struct header {
+            uint64_t magic;
+            uint64_t element_size;
+            uint64_t data_offset;
+            uint64_t capacity;
+            uint64_t head;
+            uint64_t tail;
+        };
+
+        static constexpr uint64_t magic_ = 0x31726f7463657663;  // "cvector1"
+
+        int fd_;
+        size_t page_;
+        char* base_;
+        header* header_;
+        T* data_;
+        size_t capacity_;
+
+        [[noreturn]] static void fail(const char* what) {
+            throw std::system_error(errno, std::generic_category(), what);
+        }
+
+        // the element pages must be mirrored exactly, so capacity * sizeof(T) has to be a whole number of pages
+        size_t min_capacity() const {
+            return std::max<size_t>(page_ >> std::countr_zero(sizeof(T)), 1);
+        }
+
+        size_t mapping_size(size_t capacity) const {
+            return page_ + 2 * capacity * sizeof(T);
+        }
+
+        void resize_file(size_t capacity) {
+            if (ftruncate(fd_, static_cast<off_t>(page_ + capacity * sizeof(T))) != 0) {
+                fail("mapped_cvector: ftruncate");
+            }
+        }
+
+        // map the header and element pages, followed by a second copy of the element pages
+        void map(size_t capacity) {
+            size_t bytes = capacity * sizeof(T);
+            void* reserved = mmap(nullptr, mapping_size(capacity), PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (reserved == MAP_FAILED) {
+                fail("mapped_cvector: mmap");
+            }
+            char* base = static_cast<char*>(reserved);
+            if (mmap(base, page_ + bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd_, 0) == MAP_FAILED ||
+                mmap(base + page_ + bytes, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd_,
+                     static_cast<off_t>(page_)) == MAP_FAILED) {
+                int error = errno;
+                munmap(reserved, mapping_size(capacity));
+                errno = error;
+                fail("mapped_cvector: mmap");
+            }
+            base_ = base;
+            header_ = reinterpret_cast<header*>(base);
+            data_ = reinterpret_cast<T*>(base + page_);
+            capacity_ = capacity;
+        }
+
+        void unmap() noexcept {
+            if (base_) {
+                munmap(base_, mapping_size(capacity_));
+                base_ = nullptr;
+            }
+        }
+
+        // grow the file and the mapping to new_capacity elements
+        // the element counted c moves from slot c & (old_capacity - 1) to slot c & (new_capacity - 1), which is either
+        // the same slot or one in the new part of the file, so the old slots are never overwritten and a crash
+        // before the new capacity is stored leaves the old ring intact
+        // the old mapping is only released once the new one is in place, so a failed mmap leaves the ring usable
+        void grow_capacity(size_t new_capacity) {
+            char* old_base = base_;
+            size_t old_capacity = capacity_;
+            resize_file(new_capacity);
+            map(new_capacity);
+            munmap(old_base, mapping_size(old_capacity));
+            size_t tail = header_->tail;
+            for (size_t c = header_->head; c != tail;) {
+                // elements up to the next multiple of old_capacity are contiguous in both layouts
+                size_t n = std::min(tail - c, old_capacity - (c & (old_capacity - 1)));
+                size_t from = c & (old_capacity - 1);
+                size_t to = c & (new_capacity - 1);
+                if (from != to) {
+                    memcpy(data_ + to, data_ + from, n * sizeof(T));
+                }
+                c += n;
+            }
+            std::atomic_signal_fence(std::memory_order_release);
+            header_->capacity = new_capacity;
+        }
+
+        // map the ring in the open file, creating an empty one if the file is new (empty)
+        // any other file must already hold a ring, a file of zeros is rejected rather than overwritten
+        void open_ring(const std::string& path, size_t initial_capacity) {
+            struct stat st;
+            if (fstat(fd_, &st) != 0) {
+                fail("mapped_cvector: fstat");
+            }
+            if (st.st_size == 0) {
+                size_t capacity = std::max(std::bit_ceil(std::max<size_t>(initial_capacity, 1)), min_capacity());
+                resize_file(capacity);
+                map(capacity);
+                header_->element_size = sizeof(T);
+                header_->data_offset = page_;
+                header_->capacity = capacity;
+                header_->head = 0;
+                header_->tail = 0;
+                // written last, so a ring whose creation was interrupted is never mistaken for a valid one
+                std::atomic_signal_fence(std::memory_order_release);
+                header_->magic = magic_;
+                return;
+            }
+            header h{};
+            if (static_cast<size_t>(st.st_size) >= sizeof(header) && pread(fd_, &h, sizeof(header), 0) != sizeof(header)) {
+                fail("mapped_cvector: read");
+            }
+            if (h.magic != magic_ || h.element_size != sizeof(T) || h.data_offset != page_ ||
+                !std::has_single_bit(h.capacity) || h.capacity < min_capacity() || h.tail - h.head > h.capacity ||
+                static_cast<size_t>(st.st_size) < page_ + h.capacity * sizeof(T)) {
+                throw std::runtime_error("mapped_cvector: " + path + " does not hold a ring of this element type");
+            }
+            map(h.capacity);
+            reserve(initial_capacity);
+        }
+
+    public:
+        using value_type = T;
+        using iterator = T*;
+        using const_iterator = const T*;
+
+        // open the ring stored at path, or create it with room for at least initial_capacity elements
+        // capacity is rounded up to a power of 2 that fills whole pages
+        explicit mapped_cvector(const std::string& path, size_t initial_capacity = 0)
+            : fd_(-1), page_(static_cast<size_t>(sysconf(_SC_PAGESIZE))), base_(nullptr), header_(nullptr), data_(nullptr),
+              capacity_(0) {
+            fd_ = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+            if (fd_ < 0) {
+                fail("mapped_cvector: open");
+            }
+            try {
+                open_ring(path, initial_capacity);
+            } catch (...) {
+                unmap();
+                close(fd_);
+                throw;
+            }
+        }
+
+        mapped_cvector(const mapped_cvector&) = delete;
+        mapped_cvector& operator=(const mapped_cvector&) = delete;
+
+        mapped_cvector(mapped_cvector&& other) noexcept
+            : fd_(std::exchange(other.fd_, -1)), page_(other.page_), base_(std::exchange(other.base_, nullptr)),
+              header_(std::exchange(other.header_, nullptr)), data_(std::exchange(other.data_, nullptr)),
+              capacity_(std::exchange(other.capacity_, 0)) {}
+
+        mapped_cvector& operator=(mapped_cvector&& other) noexcept {
+            swap(other);
+            return *this;
+        }
+
+        // the contents stay in the file, unflushed changes are written back by the kernel
+        ~mapped_cvector() {
+            unmap();
+            if (fd_ >= 0) {
+                close(fd_);
+            }
+        }
+
+        void swap(mapped_cvector& other) noexcept {
+            std::swap(fd_, other.fd_);
+            std::swap(page_, other.page_);
+            std::swap(base_, other.base_);
+            std::swap(header_, other.header_);
+            std::swap(data_, other.data_);
+            std::swap(capacity_, other.capacity_);
+        }
+
+        void reserve(size_t new_capacity) {
+            if (new_capacity > capacity_) {
+                grow_capacity(std::bit_ceil(new_capacity));
+            }
+        }
+
+        // each modifier writes the elements first and then publishes them with one store to head or tail
+        void push_back(const T& value) {
+            size_t tail = header_->tail;
+            if (tail - header_->head == capacity_) {
+                grow_capacity(capacity_ * 2);
+            }
+            data_[tail & (capacity_ - 1)] = value;
+            std::atomic_signal_fence(std::memory_order_release);
+            header_->tail = tail + 1;
+        }
+
+        void push_front(const T& value) {
+            size_t head = header_->head;
+            if (header_->tail - head == capacity_) {
+                grow_capacity(capacity_ * 2);
+            }
+            data_[(head - 1) & (capacity_ - 1)] = value;
+            std::atomic_signal_fence(std::memory_order_release);
+            header_->head = head - 1;
+        }
+
+        // append [first, last) after the back element as one batch, a crash never leaves part of it behind
+        // the range must not refer to elements of this ring
+        template <typename InputIt>
+        void append(InputIt first, InputIt last) {
+            if constexpr (std::forward_iterator<InputIt>) {
+                size_t n = static_cast<size_t>(std::distance(first, last));
+                reserve(size() + n);
+                size_t tail = header_->tail;
+                // the mirror keeps the free slots after the back element contiguous
+                std::copy(first, last, data_ + (tail & (capacity_ - 1)));
+                std::atomic_signal_fence(std::memory_order_release);
+                header_->tail = tail + n;
+            } else {
+                for (; first != last; ++first) {
+                    push_back(*first);
+                }
+            }
+        }
+
+        void pop_back() {
+            if (empty()) {
+                throw std::out_of_range("mapped_cvector::pop_back: size is 0");
+            }
+            header_->tail = header_->tail - 1;
+        }
+
+        void pop_front() {
+            if (empty()) {
+                throw std::out_of_range("mapped_cvector::pop_front: size is 0");
+            }
+            header_->head = header_->head + 1;
+        }
+
+        // remove the first count elements, for consumers that drain the ring in batches
+        void pop_front(size_t count) {
+            if (count > size()) {
+                throw std::out_of_range("mapped_cvector::pop_front: count is greater than size");
+            }
+            header_->head = header_->head + count;
+        }
+
+        void clear() {
+            header_->head = header_->tail;
+        }
+
+        // write the contents to disk: the element pages first, then the header, so the header on disk
+        // never describes elements that have not reached it
+        void flush() {
+            if (msync(base_ + page_, 2 * capacity_ * sizeof(T), MS_SYNC) != 0 || msync(base_, page_, MS_SYNC) != 0) {
+                fail("mapped_cvector: msync");
+            }
+        }
+
+        // the mirror makes head + index valid without masking
+        T& operator[](size_t index) {
+            return begin()[index];
+        }
+        const T& operator[](size_t index) const {
+            return begin()[index];
+        }
+
+        T& front() {
+            return *begin();
+        }
+        const T& front() const {
+            return *begin();
+        }
+
+        T& back() {
+            return data_[(header_->tail - 1) & (capacity_ - 1)];
+        }
+        const T& back() const {
+            return data_[(header_->tail - 1) & (capacity_ - 1)];
+        }
+
+        size_t size() const {
+            return header_->tail - header_->head;
+        }
+        size_t capacity() const {
+            return capacity_;
+        }
+        bool empty() const {
+            return size() == 0;
+        }
+
+        // the elements as one contiguous span, ready for write() or send()
+        std::span<T> linearize() {
+            return std::span<T>(begin(), size());
+        }
+        std::span<const T> linearize() const {
+            return std::span<const T>(begin(), size());
+        }
+
+        iterator begin() { return data_ + (header_->head & (capacity_ - 1)); }
+        const_iterator begin() const { return data_ + (header_->head & (capacity_ - 1)); }
+        const_iterator cbegin() const { return begin(); }
+
+        iterator end() { return begin() + size(); }
+        const_iterator end() const { return begin() + size(); }
+        const_iterator cend() const { return end(); }
+};
+#endif
+
+// Segmented iteration
+// an iterator is segmented if it can expose the range [first, last) as two raw spans
+// the algorithms below loop over those spans directly so the compiler sees plain pointer loops
+// they only accept segmented iterators and mirror the std signatures, so with `using namespace std` a call on cvector
+// iterators picks these (the more constrained overload) and a call on any other iterator finds only std
+template <typename It>
+concept segmented_iterator = requires(const It& first, const It& last) {
+    { first.segments(last).first.data() };
+    { first.segments(last).second.data() };
+};
+
+template <segmented_iterator It, typename F>
+F for_each(It first, It last, F f) {
+    auto [a, b] = first.segments(last);
+    f = std::for_each(a.data(), a.data() + a.size(), std::move(f));
+    return std::for_each(b.data(), b.data() + b.size(), std::move(f));
+}
+
+template <segmented_iterator It, typename OutputIt>
+OutputIt copy(It first, It last, OutputIt out) {
+    auto [a, b] = first.segments(last);
+    out = std::copy(a.data(), a.data() + a.size(), out);
+    return std::copy(b.data(), b.data() + b.size(), out);
+}
+
+template <segmented_iterator It, typename U>
+void fill(It first, It last, const U& value) {
+    auto [a, b] = first.segments(last);
+    std::fill(a.data(), a.data() + a.size(), value);
+    std::fill(b.data(), b.data() + b.size(), value);
+}
+
+template <segmented_iterator It, typename U>
+It find(It first, It last, const U& value) {
+    auto [a, b] = first.segments(last);
+    auto found = std::find(a.data(), a.data() + a.size(), value);
+    if (found != a.data() + a.size()) {
+        return first + (found - a.data());
+    }
+    found = std::find(b.data(), b.data() + b.size(), value);
+    return first + static_cast<std::ptrdiff_t>(a.size()) + (found - b.data());
+}
+
+template <segmented_iterator It, typename U, typename BinaryOp>
+U accumulate(It first, It last, U init, BinaryOp op) {
+    auto [a, b] = first.segments(last);
+    init = std::accumulate(a.data(), a.data() + a.size(), std::move(init), op);
+    return std::accumulate(b.data(), b.data() + b.size(), std::move(init), op);
+}
+
+template <segmented_iterator It, typename U>
+U accumulate(It first, It last, U init) {
+    return containers::accumulate(first, last, std::move(init), std::plus<>());
+}
+
+template <segmented_iterator It, typename OutputIt, typename UnaryOp>
+OutputIt transform(It first, It last, OutputIt out, UnaryOp op) {
+    auto [a, b] = first.segments(last);
+    out = std::transform(a.data(), a.data() + a.size(), out, op);
+    return std::transform(b.data(), b.data() + b.size(), out, op);
+}
+
+// SIMD kernels for ranges of arithmetic elements (4 or 8 byte integers, float, double)
+// each function splits a range of cvector iterators (or plain pointers) into the ring's two runs and runs a vector
+// loop over each; on x86 the loop is compiled for SSE2, AVX2 and AVX-512 and the widest one the CPU supports is
+// picked at startup, other targets (or builds with CVECTOR_NO_SIMD defined) only compile the scalar loop
+// sums and dot products are added up lane by lane, so float results can differ from a sequential sum in the last bits,
+// and min/max give an unspecified result for ranges that contain NaN
+// the kernels themselves are compiled in cvector_simd.cpp (see cvector_simd.h)
+namespace cvector_simd {
+
+enum class isa { scalar, sse2, avx2, avx512 };
+
+// the element types cvector_simd.cpp compiles kernels for
+template <typename T>
+concept element = std::same_as<T, float> || std::same_as<T, double> || std::same_as<T, int32_t> ||
+                  std::same_as<T, uint32_t> || std::same_as<T, int64_t> || std::same_as<T, uint64_t>;
+
+// the widest instruction set this CPU runs
+inline isa detect() noexcept {
+    return static_cast<isa>(simd_kernels::widest_level());
+}
+
+inline std::atomic<isa> active_isa_{detect()};
+
+inline isa active() noexcept {
+    return active_isa_.load(std::memory_order_relaxed);
+}
+
+// switch to a narrower kernel than the CPU supports, e.g. to avoid AVX-512 frequency drops or to benchmark
+// requests above what the CPU supports are clamped, the level actually used is returned
+inline isa use(isa level) noexcept {
+    level = std::min(level, detect());
+    active_isa_.store(level, std::memory_order_relaxed);
+    return level;
+}
+
+// the kernels for T at the active instruction set
+template <typename T>
+const simd_kernels::table<T>& kernels() noexcept {
+    return simd_kernels::kernels<T>(static_cast<int>(active()));
+}
+
+// the range as (at most) two contiguous runs
+template <typename It>
+auto runs(It first, It last) {
+    if constexpr (segmented_iterator<It>) {
+        return first.segments(last);
+    } else {
+        static_assert(std::contiguous_iterator<It>, "cvector_simd needs cvector iterators or contiguous iterators");
+        using span_type = std::span<std::remove_reference_t<std::iter_reference_t<It>>>;
+        return std::pair<span_type, span_type>(span_type(std::to_address(first), static_cast<size_t>(last - first)),
+                                               span_type());
+    }
+}
+
+// pointer to the element at offset into two runs, and how many elements follow it contiguously
+template <typename Span>
+std::pair<typename Span::pointer, size_t> run_at(const std::pair<Span, Span>& r, size_t offset) {
+    if (offset < r.first.size()) {
+        return {r.first.data() + offset, r.first.size() - offset};
+    }
+    offset -= r.first.size();
+    return {r.second.data() + offset, r.second.size() - offset};
+}
+
+template <typename It>
+using value_t = std::remove_cv_t<std::iter_value_t<It>>;
+
+template <typename It>
+    requires element<value_t<It>>
+value_t<It> sum(It first, It last) {
+    auto [a, b] = runs(first, last);
+    return kernels<value_t<It>>().sum(a.data(), a.size()) + kernels<value_t<It>>().sum(b.data(), b.size());
+}
+
+template <typename It>
+    requires element<value_t<It>>
+value_t<It> min(It first, It last) {
+    if (first == last) {
+        throw std::out_of_range("cvector_simd::min: empty range");
+    }
+    auto [a, b] = runs(first, last);
+    value_t<It> best = kernels<value_t<It>>().min(a.data(), a.size());
+    return b.empty() ? best : std::min(best, kernels<value_t<It>>().min(b.data(), b.size()));
+}
+
+template <typename It>
+    requires element<value_t<It>>
+value_t<It> max(It first, It last) {
+    if (first == last) {
+        throw std::out_of_range("cvector_simd::max: empty range");
+    }
+    auto [a, b] = runs(first, last);
+    value_t<It> best = kernels<value_t<It>>().max(a.data(), a.size());
+    return b.empty() ? best : std::max(best, kernels<value_t<It>>().max(b.data(), b.size()));
+}
+
+// sum of products of [first1, last1) and the range of the same length starting at first2
+// the two ranges split into runs at different points, so they are walked in pieces that are contiguous in both
+template <typename It1, typename It2>
+    requires element<value_t<It1>> && std::same_as<value_t<It1>, value_t<It2>>
+value_t<It1> dot(It1 first1, It1 last1, It2 first2) {
+    size_t n = static_cast<size_t>(last1 - first1);
+    auto x = runs(first1, last1);
+    auto y = runs(first2, first2 + static_cast<std::ptrdiff_t>(n));
+    value_t<It1> total{};
+    for (size_t done = 0; done < n;) {
+        auto [xp, xn] = run_at(x, done);
+        auto [yp, yn] = run_at(y, done);
+        size_t len = std::min(xn, yn);
+        total += kernels<value_t<It1>>().dot(xp, yp, len);
+        done += len;
+    }
+    return total;
+}
+
+template <typename It, bool GreaterEqual>
+It find_in_runs(It first, It last, value_t<It> value) {
+    auto [a, b] = runs(first, last);
+    auto kernel = GreaterEqual ? kernels<value_t<It>>().find_greater_equal : kernels<value_t<It>>().find;
+    size_t found = kernel(a.data(), a.size(), value);
+    if (found == a.size()) {
+        found += kernel(b.data(), b.size(), value);
+    }
+    return first + static_cast<std::ptrdiff_t>(found);
+}
+
+// first element equal to value, or last
+template <typename It>
+    requires element<value_t<It>>
+It find(It first, It last, value_t<It> value) {
+    return find_in_runs<It, false>(first, last, value);
+}
+
+// first element not less than value, or last; the range does not have to be sorted
+template <typename It>
+    requires element<value_t<It>>
+It find_greater_equal(It first, It last, value_t<It> value) {
+    return find_in_runs<It, true>(first, last, value);
+}
+
+// multiply every element by scale and add offset, in place
+template <typename It>
+    requires element<value_t<It>>
+void scale_add(It first, It last, value_t<It> scale, value_t<It> offset) {
+    auto [a, b] = runs(first, last);
+    kernels<value_t<It>>().scale_add(a.data(), a.size(), scale, offset);
+    kernels<value_t<It>>().scale_add(b.data(), b.size(), scale, offset);
+}
+
+} // namespace cvector_simd
+
 } // namespace containers
@@ -0,0 +1,274 @@
+// SIMD kernels for containers::cvector_simd, see cvector_simd.h
+// each kernel is written once with vector extensions and compiled at every width into functions
+// marked with the matching target attribute, so one binary carries SSE2, AVX2 and AVX-512 code
+
+#include "cvector_simd.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+
+namespace containers::simd_kernels {
+namespace {
+
+// each kernel has run<Bytes>(...), a loop over vectors of Bytes bytes followed by a scalar loop for the rest
+// run<sizeof(T)> skips the vector loop and is the scalar fallback; kernels are always inlined into the dispatch
+// functions below (call), which are compiled for the matching instruction set
+template <typename T>
+struct sum_kernel {
+    using value_type = T;
+
+    template <size_t Bytes>
+    [[gnu::always_inline]] static T run(const T* p, size_t n) {
+        constexpr size_t lanes = Bytes / sizeof(T);
+        T total{};
+        size_t i = 0;
+        if constexpr (lanes > 1) {
+            using V [[gnu::vector_size(Bytes)]] = T;
+            // four accumulators hide the latency of the adds
+            V acc[4] = {};
+            for (; i + 4 * lanes <= n; i += 4 * lanes) {
+                for (size_t k = 0; k < 4; ++k) {
+                    V v;
+                    memcpy(&v, p + i + k * lanes, Bytes);
+                    acc[k] += v;
+                }
+            }
+            for (; i + lanes <= n; i += lanes) {
+                V v;
+                memcpy(&v, p + i, Bytes);
+                acc[0] += v;
+            }
+            acc[0] = (acc[0] + acc[1]) + (acc[2] + acc[3]);
+            for (size_t l = 0; l < lanes; ++l) {
+                total += acc[0][l];
+            }
+        }
+        for (; i < n; ++i) {
+            total += p[i];
+        }
+        return total;
+    }
+};
+
+// smallest (Max = false) or largest element, n must be at least 1
+template <typename T, bool Max>
+struct extreme_kernel {
+    using value_type = T;
+
+    template <size_t Bytes>
+    [[gnu::always_inline]] static T run(const T* p, size_t n) {
+        constexpr size_t lanes = Bytes / sizeof(T);
+        T best = p[0];
+        size_t i = 1;
+        if constexpr (lanes > 1) {
+            using V [[gnu::vector_size(Bytes)]] = T;
+            if (n >= lanes) {
+                V acc;
+                memcpy(&acc, p, Bytes);
+                for (i = lanes; i + lanes <= n; i += lanes) {
+                    V v;
+                    memcpy(&v, p + i, Bytes);
+                    if constexpr (Max) {
+                        acc = v > acc ? v : acc;
+                    } else {
+                        acc = v < acc ? v : acc;
+                    }
+                }
+                best = acc[0];
+                for (size_t l = 1; l < lanes; ++l) {
+                    best = Max ? std::max(best, acc[l]) : std::min(best, acc[l]);
+                }
+            }
+        }
+        for (; i < n; ++i) {
+            best = Max ? std::max(best, p[i]) : std::min(best, p[i]);
+        }
+        return best;
+    }
+};
+
+template <typename T>
+struct dot_kernel {
+    using value_type = T;
+
+    template <size_t Bytes>
+    [[gnu::always_inline]] static T run(const T* x, const T* y, size_t n) {
+        constexpr size_t lanes = Bytes / sizeof(T);
+        T total{};
+        size_t i = 0;
+        if constexpr (lanes > 1) {
+            using V [[gnu::vector_size(Bytes)]] = T;
+            V acc[4] = {};
+            for (; i + 4 * lanes <= n; i += 4 * lanes) {
+                for (size_t k = 0; k < 4; ++k) {
+                    V a, b;
+                    memcpy(&a, x + i + k * lanes, Bytes);
+                    memcpy(&b, y + i + k * lanes, Bytes);
+                    acc[k] += a * b;
+                }
+            }
+            for (; i + lanes <= n; i += lanes) {
+                V a, b;
+                memcpy(&a, x + i, Bytes);
+                memcpy(&b, y + i, Bytes);
+                acc[0] += a * b;
+            }
+            acc[0] = (acc[0] + acc[1]) + (acc[2] + acc[3]);
+            for (size_t l = 0; l < lanes; ++l) {
+                total += acc[0][l];
+            }
+        }
+        for (; i < n; ++i) {
+            total += x[i] * y[i];
+        }
+        return total;
+    }
+};
+
+// index of the first element equal to (GreaterEqual = false) or not less than value, n if there is none
+template <typename T, bool GreaterEqual>
+struct find_kernel {
+    using value_type = T;
+
+    template <size_t Bytes>
+    [[gnu::always_inline]] static size_t run(const T* p, size_t n, T value) {
+        constexpr size_t lanes = Bytes / sizeof(T);
+        size_t i = 0;
+        if constexpr (lanes > 1) {
+            using V [[gnu::vector_size(Bytes)]] = T;
+            for (; i + lanes <= n; i += lanes) {
+                V v;
+                memcpy(&v, p + i, Bytes);
+                auto hit = GreaterEqual ? v >= value : v == value;
+                // the comparison sets every bit of a matching lane, so any match leaves a nonzero word
+                uint64_t words[Bytes / 8];
+                memcpy(words, &hit, Bytes);
+                uint64_t any = 0;
+                for (uint64_t word : words) {
+                    any |= word;
+                }
+                if (any) {
+                    break;
+                }
+            }
+        }
+        for (; i < n; ++i) {
+            if (GreaterEqual ? p[i] >= value : p[i] == value) {
+                return i;
+            }
+        }
+        return n;
+    }
+};
+
+// p[i] = p[i] * scale + offset
+template <typename T>
+struct scale_add_kernel {
+    using value_type = T;
+
+    template <size_t Bytes>
+    [[gnu::always_inline]] static void run(T* p, size_t n, T scale, T offset) {
+        constexpr size_t lanes = Bytes / sizeof(T);
+        size_t i = 0;
+        if constexpr (lanes > 1) {
+            using V [[gnu::vector_size(Bytes)]] = T;
+            for (; i + lanes <= n; i += lanes) {
+                V v;
+                memcpy(&v, p + i, Bytes);
+                v = v * scale + offset;
+                memcpy(p + i, &v, Bytes);
+            }
+        }
+        for (; i < n; ++i) {
+            p[i] = p[i] * scale + offset;
+        }
+    }
+};
+
+// one instruction set: call<Kernel>(...) runs the kernel at that width, compiled for that target
+struct scalar_isa {
+    template <typename Kernel, typename R, typename... Args>
+    static R call(Args... args) {
+        return Kernel::template run<sizeof(typename Kernel::value_type)>(args...);
+    }
+};
+
+#if CVECTOR_SIMD_X86
+struct sse2_isa {
+    template <typename Kernel, typename R, typename... Args>
+    [[gnu::target("sse2")]] static R call(Args... args) {
+        return Kernel::template run<16>(args...);
+    }
+};
+
+struct avx2_isa {
+    template <typename Kernel, typename R, typename... Args>
+    [[gnu::target("avx2")]] static R call(Args... args) {
+        return Kernel::template run<32>(args...);
+    }
+};
+
+struct avx512_isa {
+    template <typename Kernel, typename R, typename... Args>
+    [[gnu::target("avx512f")]] static R call(Args... args) {
+        return Kernel::template run<64>(args...);
+    }
+};
+#endif
+
+template <typename T, typename Isa>
+constexpr table<T> make_table() {
+    return table<T>{
+        &Isa::template call<sum_kernel<T>, T, const T*, size_t>,
+        &Isa::template call<extreme_kernel<T, false>, T, const T*, size_t>,
+        &Isa::template call<extreme_kernel<T, true>, T, const T*, size_t>,
+        &Isa::template call<dot_kernel<T>, T, const T*, const T*, size_t>,
+        &Isa::template call<find_kernel<T, false>, size_t, const T*, size_t, T>,
+        &Isa::template call<find_kernel<T, true>, size_t, const T*, size_t, T>,
+        &Isa::template call<scale_add_kernel<T>, void, T*, size_t, T, T>,
+    };
+}
+
+template <typename T>
+constexpr table<T> tables[] = {
+    make_table<T, scalar_isa>(),
+#if CVECTOR_SIMD_X86
+    make_table<T, sse2_isa>(),
+    make_table<T, avx2_isa>(),
+    make_table<T, avx512_isa>(),
+#endif
+};
+
+} // namespace
+
+int widest_level() noexcept {
+#if CVECTOR_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return 3;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return 2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return 1;
+    }
+#endif
+    return 0;
+}
+
+template <typename T>
+const table<T>& kernels(int level) noexcept {
+    return tables<T>[std::min<size_t>(static_cast<size_t>(level), std::size(tables<T>) - 1)];
+}
+
+template const table<float>& kernels<float>(int) noexcept;
+template const table<double>& kernels<double>(int) noexcept;
+template const table<int32_t>& kernels<int32_t>(int) noexcept;
+template const table<uint32_t>& kernels<uint32_t>(int) noexcept;
+template const table<int64_t>& kernels<int64_t>(int) noexcept;
+template const table<uint64_t>& kernels<uint64_t>(int) noexcept;
+
+} // namespace containers::simd_kernels
@@ -0,0 +1,41 @@
+#pragma once
+
+// SIMD kernels behind containers::cvector_simd, compiled in cvector_simd.cpp
+// they are kept out of the cvector module interface because GCC cannot yet write functions with a target
+// attribute (or calls to __builtin_cpu_supports) into a module, so the module only sees these declarations
+// and calls the kernels through pointers
+
+#include <cstddef>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && !defined(CVECTOR_NO_SIMD)
+#define CVECTOR_SIMD_X86 1
+#else
+#define CVECTOR_SIMD_X86 0
+#endif
+
+namespace containers::simd_kernels {
+
+// the kernels for one element type at one instruction set; all of them work on a single contiguous run
+template <typename T>
+struct table {
+    T (*sum)(const T* p, size_t n);
+    // min and max need n >= 1
+    T (*min)(const T* p, size_t n);
+    T (*max)(const T* p, size_t n);
+    T (*dot)(const T* x, const T* y, size_t n);
+    // index of the first element equal to (not less than) value, n if there is none
+    size_t (*find)(const T* p, size_t n, T value);
+    size_t (*find_greater_equal)(const T* p, size_t n, T value);
+    // p[i] = p[i] * scale + offset
+    void (*scale_add)(T* p, size_t n, T scale, T offset);
+};
+
+// the widest level this CPU runs: 0 (scalar), 1 (SSE2), 2 (AVX2) or 3 (AVX-512)
+int widest_level() noexcept;
+
+// kernels for level 0 (scalar), 1 (SSE2), 2 (AVX2) or 3 (AVX-512), the caller checks that the CPU supports it
+// defined for float, double, int32_t, uint32_t, int64_t and uint64_t; without CVECTOR_SIMD_X86 every level is scalar
+template <typename T>
+const table<T>& kernels(int level) noexcept;
+
+} // namespace containers::simd_kernels
@@ -0,0 +1,547 @@
+module;
+
+// Traditional includes in global module fragment
+#include <type_traits>
+#include <memory>
+#include <utility>
+#include <cstddef>
+#include <iterator>
+#include <bit>
+#include <new>
+#include <stdexcept>
+#include <algorithm>
+
+export module deque;
+
+import cvector;
+
+export namespace containers {
+
+// free list of fixed-size node blocks, so that nodes can be recycled instead of freed
+// released blocks are kept up to a high-water mark of max_free blocks, beyond that they are freed
+// a pool is not thread safe: share one between deques of the same thread, e.g. thread_local_pool()
+template <size_t BlockSize, size_t BlockAlign>
+class node_pool {
+    private:
+        // released blocks are linked through their own storage
+        struct free_block {
+            free_block* next;
+        };
+        static_assert(BlockSize >= sizeof(free_block), "node_pool blocks must fit a free list link");
+
+        free_block* head_;
+        size_t free_count_;
+        size_t max_free_;
+
+    public:
+        static constexpr size_t default_max_free = 64;
+
+        explicit node_pool(size_t max_free = default_max_free) : head_(nullptr), free_count_(0), max_free_(max_free) {}
+
+        node_pool(const node_pool&) = delete;
+        node_pool& operator=(const node_pool&) = delete;
+
+        node_pool(node_pool&& other) noexcept
+            : head_(other.head_), free_count_(other.free_count_), max_free_(other.max_free_) {
+            other.head_ = nullptr;
+            other.free_count_ = 0;
+        }
+
+        ~node_pool() {
+            trim(0);
+        }
+
+        void swap(node_pool& other) noexcept {
+            std::swap(head_, other.head_);
+            std::swap(free_count_, other.free_count_);
+            std::swap(max_free_, other.max_free_);
+        }
+
+        // a recycled block if one is available, otherwise a new allocation
+        void* acquire() {
+            if (head_) {
+                free_block* block = head_;
+                head_ = block->next;
+                free_count_--;
+                return block;
+            }
+            return ::operator new(BlockSize, std::align_val_t(BlockAlign));
+        }
+
+        void release(void* block) noexcept {
+            if (free_count_ >= max_free_) {
+                ::operator delete(block, std::align_val_t(BlockAlign));
+                return;
+            }
+            head_ = new (block) free_block{head_};
+            free_count_++;
+        }
+
+        // allocate blocks up front until count are free (bounded by the high-water mark)
+        void reserve(size_t count) {
+            count = std::min(count, max_free_);
+            while (free_count_ < count) {
+                head_ = new (::operator new(BlockSize, std::align_val_t(BlockAlign))) free_block{head_};
+                free_count_++;
+            }
+        }
+
+        // free blocks until at most keep are left
+        void trim(size_t keep) noexcept {
+            while (free_count_ > keep) {
+                free_block* block = head_;
+                head_ = block->next;
+                ::operator delete(block, std::align_val_t(BlockAlign));
+                free_count_--;
+            }
+        }
+
+        size_t free_count() const {
+            return free_count_;
+        }
+        size_t max_free() const {
+            return max_free_;
+        }
+        void set_max_free(size_t max_free) {
+            max_free_ = max_free;
+            trim(max_free);
+        }
+
+        // one pool per thread for every deque whose nodes have this size and alignment
+        static node_pool& thread_local_pool() {
+            thread_local node_pool pool;
+            return pool;
+        }
+};
+
+// segmented double-ended queue
+// elements live in fixed-size nodes that never move, so references stay valid under push/pop at both ends
+template <typename T>
+class deque {
+    private:
+        // nodes hold about 512 bytes (at least 4 elements), the same as libstdc++ std::deque nodes
+        // node_size_ is a power of 2 so that / and % compile to shifts and masks
+        static constexpr size_t node_size_ = std::bit_floor(std::max<size_t>(4, 512 / sizeof(T)));
+
+        struct node {
+            alignas(T) unsigned char storage[node_size_ * sizeof(T)];
+
+            T* slots() {
+                return std::launder(reinterpret_cast<T*>(storage));
+            }
+        };
+
+        // circular vector of node pointers
+        // the true index of an element is its placement within the list of all nodes
+        // data_ can contain unused nodes at the beginning and end (to be reused later)
+        // moving a spare node from one end to the other is O(1) since data_ is itself a ring
+        cvector<node*> data_;
+
+        // the true index of the front element within the list of nodes
+        // divide by node_size_ to get the node index
+        // use modulo to get the element index within the node
+        size_t front_offset_;
+
+        // the true index one past the back element
+        // the number of elements is back_offset_ - front_offset_
+        size_t back_offset_;
+
+        // cached addresses of the front and back elements (only meaningful while the deque is not empty)
+        // push/pop only go through data_ when they cross a node boundary
+        T* front_;
+        T* back_;
+
+    public:
+        using pool_type = node_pool<sizeof(node), alignof(node)>;
+
+    private:
+        // nodes come from and return to shared_pool_ if set, otherwise own_pool_
+        pool_type own_pool_;
+        pool_type* shared_pool_;
+
+        node* new_node() {
+            return new (pool().acquire()) node;
+        }
+
+        // nodes hold raw storage, so there is nothing to destroy
+        void free_node(node* node_ptr) {
+            pool().release(node_ptr);
+        }
+
+        T* slot(size_t true_index) {
+            return data_[true_index / node_size_]->slots() + true_index % node_size_;
+        }
+        const T* slot(size_t true_index) const {
+            return data_[true_index / node_size_]->slots() + true_index % node_size_;
+        }
+
+        // number of nodes holding at least one element, counted from the start of data_
+        size_t used_nodes() const {
+            return (back_offset_ + node_size_ - 1) / node_size_;
+        }
+
+        // make sure a node exists for the true index back_offset_
+        void reserve_back_slot() {
+            if (back_offset_ / node_size_ < data_.size()) {
+                return;
+            }
+            if (front_offset_ >= node_size_) { // unused node at the front can be used
+                node* node_ptr = data_.front();
+                data_.pop_front();
+                data_.push_back(node_ptr);
+                front_offset_ -= node_size_;
+                back_offset_ -= node_size_;
+            } else { // no unused node at the front, so take one from the pool
+                // grow the map first so that a throwing reallocation can't leak the node
+                data_.reserve(data_.size() + 1);
+                data_.push_back(new_node());
+            }
+        }
+
+        // the slot for a push_back that crosses into a new node (or goes into an empty deque)
+        // kept out of line so that emplace_back inlines down to the pointer bump into the current node
+        [[gnu::noinline]] T* next_back_slot() {
+            reserve_back_slot();
+            T* where = slot(back_offset_);
+            // an empty deque's front is the element about to be pushed (meaningless if constructing it throws)
+            if (empty()) {
+                front_ = where;
+            }
+            return where;
+        }
+
+        // the slot for a push_front that crosses into a new node (or goes into an empty deque)
+        [[gnu::noinline]] T* next_front_slot() {
+            reserve_front_slot();
+            T* where = slot(front_offset_ - 1);
+            if (empty()) {
+                back_ = where;
+            }
+            return where;
+        }
+
+        // make sure a node exists for the true index front_offset_ - 1
+        void reserve_front_slot() {
+            if (front_offset_ > 0) {
+                return;
+            }
+            if (used_nodes() < data_.size()) { // unused node at the back can be used
+                node* node_ptr = data_.back();
+                data_.pop_back();
+                data_.push_front(node_ptr);
+            } else { // no unused node at the back, so take one from the pool
+                data_.reserve(data_.size() + 1);
+                data_.push_front(new_node());
+            }
+            front_offset_ += node_size_;
+            back_offset_ += node_size_;
+        }
+
+    public:
+        deque() : front_offset_(0), back_offset_(0), front_(nullptr), back_(nullptr), shared_pool_(nullptr) {}
+
+        // recycle nodes through a pool shared with other deques, which must outlive this deque
+        explicit deque(pool_type& pool)
+            : front_offset_(0), back_offset_(0), front_(nullptr), back_(nullptr), shared_pool_(&pool) {}
+
+        // the copy shares the pool of other if it has a shared one
+        deque(const deque& other)
+            : front_offset_(0), back_offset_(0), front_(nullptr), back_(nullptr), shared_pool_(other.shared_pool_) {
+            try {
+                for (size_t i = 0; i < other.size(); ++i) {
+                    push_back(other[i]);
+                }
+            } catch (...) {
+                clear();
+                shrink_to_fit();
+                throw;
+            }
+        }
+
+        // node pointers move with the map, no element is touched
+        deque(deque&& other) noexcept
+            : data_(std::move(other.data_)), front_offset_(other.front_offset_), back_offset_(other.back_offset_),
+              front_(other.front_), back_(other.back_),
+              own_pool_(std::move(other.own_pool_)), shared_pool_(other.shared_pool_) {
+            other.front_offset_ = 0;
+            other.back_offset_ = 0;
+        }
+
+        ~deque() {
+            clear();
+            shrink_to_fit();
+        }
+
+        deque& operator=(const deque& other) {
+            if (this != &other) {
+                deque tmp(other);
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        deque& operator=(deque&& other) noexcept {
+            if (this != &other) {
+                deque tmp(std::move(other));
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        void swap(deque& other) noexcept {
+            data_.swap(other.data_);
+            std::swap(front_offset_, other.front_offset_);
+            std::swap(back_offset_, other.back_offset_);
+            std::swap(front_, other.front_);
+            std::swap(back_, other.back_);
+            own_pool_.swap(other.own_pool_);
+            std::swap(shared_pool_, other.shared_pool_);
+        }
+
+        friend void swap(deque& a, deque& b) noexcept {
+            a.swap(b);
+        }
+
+        // clear the deque, but don't free the nodes
+        void clear() {
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                for (size_t i = front_offset_; i < back_offset_; i++) {
+                    slot(i)->~T();
+                }
+            }
+            front_offset_ = 0;
+            back_offset_ = 0;
+        }
+
+        // return the unused nodes at the front and back to the pool
+        // the node map keeps its capacity, a deque that drains and refills would otherwise reallocate it every time
+        void shrink_to_fit() {
+            if (empty()) {
+                front_offset_ = 0;
+                back_offset_ = 0;
+            }
+            while (front_offset_ >= node_size_) {
+                free_node(data_.front());
+                data_.pop_front();
+                front_offset_ -= node_size_;
+                back_offset_ -= node_size_;
+            }
+            while (data_.size() > used_nodes()) {
+                free_node(data_.back());
+                data_.pop_back();
+            }
+        }
+
+        // construct at the back, only allocate new nodes if necessary
+        template <typename... Args>
+        T& emplace_back(Args&&... args) {
+            T* where = back_offset_ % node_size_ != 0 && !empty() ? back_ + 1 : next_back_slot();
+            new (where) T(std::forward<Args>(args)...);
+            back_ = where;
+            back_offset_++;
+            return *where;
+        }
+
+        // construct at the front, only allocate new nodes if necessary
+        template <typename... Args>
+        T& emplace_front(Args&&... args) {
+            T* where = front_offset_ % node_size_ != 0 && !empty() ? front_ - 1 : next_front_slot();
+            new (where) T(std::forward<Args>(args)...);
+            front_ = where;
+            front_offset_--;
+            return *where;
+        }
+
+        void push_back(const T& value) {
+            emplace_back(value);
+        }
+
+        void push_back(T&& value) {
+            emplace_back(std::move(value));
+        }
+
+        void push_front(const T& value) {
+            emplace_front(value);
+        }
+
+        void push_front(T&& value) {
+            emplace_front(std::move(value));
+        }
+
+        // pop from back, but don't free the node
+        void pop_back() {
+            if (empty()) {
+                throw std::out_of_range("deque::pop_back: size is 0");
+            }
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                back_->~T();
+            }
+            back_offset_--;
+            // the old back was the first slot of its node if its true index is a multiple of node_size_
+            if (back_offset_ % node_size_ != 0) {
+                back_--;
+            } else if (!empty()) {
+                back_ = slot(back_offset_ - 1);
+            }
+        }
+
+        // pop from front, but don't free the node
+        void pop_front() {
+            if (empty()) {
+                throw std::out_of_range("deque::pop_front: size is 0");
+            }
+            if constexpr (!std::is_trivially_destructible_v<T>) {
+                front_->~T();
+            }
+            front_offset_++;
+            if (front_offset_ % node_size_ != 0) {
+                front_++;
+            } else if (!empty()) {
+                front_ = slot(front_offset_);
+            }
+        }
+
+        T& front() {
+            return *front_;
+        }
+        const T& front() const {
+            return *front_;
+        }
+
+        T& back() {
+            return *back_;
+        }
+        const T& back() const {
+            return *back_;
+        }
+
+        T& operator[](size_t index) {
+            return *slot(front_offset_ + index);
+        }
+        const T& operator[](size_t index) const {
+            return *slot(front_offset_ + index);
+        }
+
+        size_t size() const {
+            return back_offset_ - front_offset_;
+        }
+        bool empty() const {
+            return back_offset_ == front_offset_;
+        }
+        // the pool nodes are recycled through
+        pool_type& pool() {
+            return shared_pool_ ? *shared_pool_ : own_pool_;
+        }
+
+        // number of nodes currently held, including unused ones
+        size_t node_count() const {
+            return data_.size();
+        }
+        static constexpr size_t node_capacity() {
+            return node_size_;
+        }
+
+        // Iterator implementation
+        // iterators hold a logical index, so they are invalidated by push_front/pop_front
+        class iterator {
+        private:
+            deque* container_;
+            size_t index_;
+
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = T*;
+            using reference = T&;
+
+            iterator() : container_(nullptr), index_(0) {}
+            iterator(deque* container, size_t index) : container_(container), index_(index) {}
+
+            reference operator*() const { return (*container_)[index_]; }
+            pointer operator->() const { return &(*container_)[index_]; }
+
+            iterator& operator++() { ++index_; return *this; }
+            iterator operator++(int) { iterator tmp = *this; ++index_; return tmp; }
+            iterator& operator--() { --index_; return *this; }
+            iterator operator--(int) { iterator tmp = *this; --index_; return tmp; }
+
+            iterator& operator+=(difference_type n) { index_ += n; return *this; }
+            iterator& operator-=(difference_type n) { index_ -= n; return *this; }
+            iterator operator+(difference_type n) const { return iterator(container_, index_ + n); }
+            iterator operator-(difference_type n) const { return iterator(container_, index_ - n); }
+            friend iterator operator+(difference_type n, const iterator& it) { return it + n; }
+            difference_type operator-(const iterator& other) const {
+                return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+            }
+
+            bool operator==(const iterator& other) const { return index_ == other.index_; }
+            bool operator!=(const iterator& other) const { return index_ != other.index_; }
+            bool operator<(const iterator& other) const { return index_ < other.index_; }
+            bool operator<=(const iterator& other) const { return index_ <= other.index_; }
+            bool operator>(const iterator& other) const { return index_ > other.index_; }
+            bool operator>=(const iterator& other) const { return index_ >= other.index_; }
+
+            reference operator[](difference_type n) const { return (*container_)[index_ + n]; }
+
+            friend class const_iterator;
+        };
+
+        class const_iterator {
+        private:
+            const deque* container_;
+            size_t index_;
+
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = T;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const T*;
+            using reference = const T&;
+
+            const_iterator() : container_(nullptr), index_(0) {}
+            const_iterator(const deque* container, size_t index) : container_(container), index_(index) {}
+            const_iterator(const iterator& it) : container_(it.container_), index_(it.index_) {}
+
+            reference operator*() const { return (*container_)[index_]; }
+            pointer operator->() const { return &(*container_)[index_]; }
+
+            const_iterator& operator++() { ++index_; return *this; }
+            const_iterator operator++(int) { const_iterator tmp = *this; ++index_; return tmp; }
+            const_iterator& operator--() { --index_; return *this; }
+            const_iterator operator--(int) { const_iterator tmp = *this; --index_; return tmp; }
+
+            const_iterator& operator+=(difference_type n) { index_ += n; return *this; }
+            const_iterator& operator-=(difference_type n) { index_ -= n; return *this; }
+            const_iterator operator+(difference_type n) const { return const_iterator(container_, index_ + n); }
+            const_iterator operator-(difference_type n) const { return const_iterator(container_, index_ - n); }
+            friend const_iterator operator+(difference_type n, const const_iterator& it) { return it + n; }
+            difference_type operator-(const const_iterator& other) const {
+                return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+            }
+
+            bool operator==(const const_iterator& other) const { return index_ == other.index_; }
+            bool operator!=(const const_iterator& other) const { return index_ != other.index_; }
+            bool operator<(const const_iterator& other) const { return index_ < other.index_; }
+            bool operator<=(const const_iterator& other) const { return index_ <= other.index_; }
+            bool operator>(const const_iterator& other) const { return index_ > other.index_; }
+            bool operator>=(const const_iterator& other) const { return index_ >= other.index_; }
+
+            reference operator[](difference_type n) const { return (*container_)[index_ + n]; }
+        };
+
+        iterator begin() { return iterator(this, 0); }
+        const_iterator begin() const { return const_iterator(this, 0); }
+        const_iterator cbegin() const { return const_iterator(this, 0); }
+
+        iterator end() { return iterator(this, size()); }
+        const_iterator end() const { return const_iterator(this, size()); }
+        const_iterator cend() const { return const_iterator(this, size()); }
+
+        std::reverse_iterator<iterator> rbegin() { return std::reverse_iterator<iterator>(end()); }
+        std::reverse_iterator<const_iterator> rbegin() const { return std::reverse_iterator<const_iterator>(end()); }
+        std::reverse_iterator<iterator> rend() { return std::reverse_iterator<iterator>(begin()); }
+        std::reverse_iterator<const_iterator> rend() const { return std::reverse_iterator<const_iterator>(begin()); }
+};
+
+} // namespace containers
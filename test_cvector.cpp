@@ -1,6 +1,22 @@
 #include <iostream>
 #include <algorithm>
 #include <string>
+#include <vector>
+#include <span>
+#include <thread>
+#include <chrono>
+#include <memory>
+#include <memory_resource>
+#include <numeric>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <deque>
+#include <random>
+#include <bit>
+#include <cmath>
+#include <stdexcept>
 import cvector;
 
 using namespace containers;
@@ -166,6 +182,1281 @@ void test_algorithms() {
     std::cout << std::endl;
 }
 
+void test_move_and_emplace() {
+    std::cout << "\n=== Testing Move and Emplace ===" << std::endl;
+    
+    cvector<std::string> words;
+    std::string moved = "moved into back";
+    words.push_back(std::move(moved));
+    words.push_front(std::string("moved into front"));
+    words.emplace_back(3, 'x');
+    words.emplace_front("emplaced");
+    
+    std::cout << "Source string after move: '" << moved << "'" << std::endl;
+    std::cout << "All elements: ";
+    for (size_t i = 0; i < words.size(); ++i) {
+        std::cout << "'" << words[i] << "' ";
+    }
+    std::cout << std::endl;
+    
+    // Emplacing a copy of an existing element must survive the growth it triggers
+    cvector<std::string> self_ref;
+    self_ref.push_back("self");
+    for (int i = 0; i < 4; ++i) {
+        self_ref.emplace_back(self_ref.front());
+    }
+    std::cout << "Self-referencing emplace: size=" << self_ref.size() << ", back() = '" << self_ref.back() << "'" << std::endl;
+}
+
+void test_copy_move_swap() {
+    std::cout << "\n=== Testing Copy, Move and Swap ===" << std::endl;
+    
+    // Build a wrapped ring so the copy has to unwrap two segments
+    cvector<int> ring;
+    ring.reserve(8);
+    for (int i = 1; i <= 6; ++i) {
+        ring.push_back(i);
+    }
+    ring.pop_front();
+    ring.pop_front();
+    ring.push_back(7);
+    ring.push_back(8);
+    ring.push_back(9);
+    
+    cvector<int> copy(ring);
+    std::cout << "Copy of wrapped ring: ";
+    for (size_t i = 0; i < copy.size(); ++i) {
+        std::cout << copy[i] << " ";
+    }
+    std::cout << "(capacity=" << copy.capacity() << ")" << std::endl;
+    
+    cvector<std::string> words;
+    words.push_back("alpha");
+    words.push_back("beta");
+    words.push_front("omega");
+    
+    cvector<std::string> words_copy;
+    words_copy = words;
+    words_copy.push_back("gamma");
+    std::cout << "Original size=" << words.size() << ", copy size=" << words_copy.size() << std::endl;
+    
+    cvector<std::string> moved(std::move(words_copy));
+    std::cout << "After move: source size=" << words_copy.size() << ", target size=" << moved.size() << std::endl;
+    
+    swap(words, moved);
+    std::cout << "After swap: words.back() = '" << words.back() << "', moved.back() = '" << moved.back() << "'" << std::endl;
+    
+    // cvectors relocate inside a std::vector without copying their elements
+    std::vector<cvector<std::string>> rings;
+    for (int i = 0; i < 4; ++i) {
+        rings.push_back(cvector<std::string>(2));
+        rings.back().push_back("ring " + std::to_string(i));
+    }
+    std::cout << "Rings in std::vector: " << rings.size() << ", last holds '" << rings.back().back() << "'" << std::endl;
+}
+
+void test_bulk_operations() {
+    std::cout << "\n=== Testing Bulk Operations ===" << std::endl;
+    
+    std::vector<int> batch = {4, 5, 6, 7};
+    std::vector<int> header = {1, 2, 3};
+    
+    cvector<int> vec;
+    vec.append(batch.begin(), batch.end());
+    vec.prepend(header.begin(), header.end());
+    std::cout << "After append/prepend: ";
+    for (const auto& elem : vec) {
+        std::cout << elem << " ";
+    }
+    std::cout << "(size=" << vec.size() << ", capacity=" << vec.capacity() << ")" << std::endl;
+    
+    // Fill the ring completely so that begin() and end() refer to the same slot
+    vec.push_back(8);
+    std::cout << "Full ring: ";
+    for (const auto& elem : vec) {
+        std::cout << elem << " ";
+    }
+    std::cout << "(size=" << vec.size() << ", capacity=" << vec.capacity() << ")" << std::endl;
+    
+    std::vector<int> middle = {100, 200};
+    auto it = vec.insert(vec.begin() + 2, middle.begin(), middle.end());
+    std::cout << "After insert at 2 (returned " << *it << "): ";
+    for (const auto& elem : vec) {
+        std::cout << elem << " ";
+    }
+    std::cout << std::endl;
+    
+    vec.insert(vec.end() - 1, middle.begin(), middle.end());
+    std::cout << "After insert before back: ";
+    for (const auto& elem : vec) {
+        std::cout << elem << " ";
+    }
+    std::cout << std::endl;
+    
+    std::vector<std::string> names = {"ann", "bob", "cid"};
+    cvector<std::string> words;
+    words.push_back("old");
+    words.assign(names.begin(), names.end());
+    words.prepend(names.rbegin(), names.rend());
+    std::cout << "Strings after assign/prepend: ";
+    for (const auto& word : words) {
+        std::cout << "'" << word << "' ";
+    }
+    std::cout << std::endl;
+    
+    // Single pass and move-only ranges are buffered once, then prepended or inserted
+    static_assert(std::random_access_iterator<cvector<int>::iterator>);
+    static_assert(std::random_access_iterator<cvector<int>::const_iterator>);
+    std::istringstream numbers("1 2 3");
+    cvector<int> streamed;
+    streamed.push_back(4);
+    streamed.prepend(std::istream_iterator<int>(numbers), std::istream_iterator<int>());
+    std::vector<std::string> long_words = {"a string long enough to be moved rather than copied", "and another one"};
+    words.prepend(std::make_move_iterator(long_words.begin()), std::make_move_iterator(long_words.end()));
+    std::istringstream more("-2 -1");
+    streamed.insert(streamed.begin() + 1, std::istream_iterator<int>(more), std::istream_iterator<int>());
+    cvector<int> source;
+    source.push_back(10);
+    source.push_back(20);
+    streamed.insert(streamed.begin() + 1, source.begin(), source.end());
+    std::cout << "Prepended and inserted from single pass ranges: ";
+    for (int elem : streamed) {
+        std::cout << elem << " ";
+    }
+    std::cout << "| moved-in front: '" << words.front() << "', source emptied: " << long_words.front().empty() << std::endl;
+}
+
+void test_spans() {
+    std::cout << "\n=== Testing Span Views ===" << std::endl;
+    
+    cvector<int> vec;
+    vec.reserve(8);
+    for (int i = 1; i <= 6; ++i) {
+        vec.push_back(i);
+    }
+    vec.push_front(0);
+    vec.push_front(-1);
+    
+    auto [head_part, wrapped_part] = vec.as_spans();
+    std::cout << "Head segment: ";
+    for (int elem : head_part) {
+        std::cout << elem << " ";
+    }
+    std::cout << "| wrapped segment: ";
+    for (int elem : wrapped_part) {
+        std::cout << elem << " ";
+    }
+    std::cout << std::endl;
+    
+    std::span<int> flat = vec.linearize();
+    std::cout << "Linearized (" << flat.size() << " elements, segments " << vec.as_spans().first.size()
+              << "+" << vec.as_spans().second.size() << "): ";
+    for (int elem : flat) {
+        std::cout << elem << " ";
+    }
+    std::cout << std::endl;
+    
+    // Non-trivial elements with free slots are relocated rather than rotated
+    cvector<std::string> words;
+    words.reserve(8);
+    words.push_back("c");
+    words.push_back("d");
+    words.push_front("b");
+    words.push_front("a");
+    std::cout << "String segments before: " << words.as_spans().first.size() << "+" << words.as_spans().second.size();
+    std::span<std::string> flat_words = words.linearize();
+    std::cout << ", after: ";
+    for (const auto& word : flat_words) {
+        std::cout << "'" << word << "' ";
+    }
+    std::cout << std::endl;
+    
+    // Every split of a wrapped ring into its two runs and the free slots between them
+    bool ints_match = true, pointers_match = true;
+    for (int head = 1; head < 16; ++head) {
+        for (int size = 17 - head; size <= 16; ++size) {
+            cvector<int> ints;
+            cvector<std::unique_ptr<int>> pointers;
+            ints.reserve(16);
+            pointers.reserve(16);
+            for (int i = 0; i < head; ++i) {
+                ints.push_back(0);
+                ints.pop_front();
+                pointers.push_back(nullptr);
+                pointers.pop_front();
+            }
+            for (int i = 0; i < size; ++i) {
+                ints.push_back(i);
+                pointers.push_back(std::make_unique<int>(i));
+            }
+            std::span<int> flat_ints = ints.linearize();
+            std::span<std::unique_ptr<int>> flat_pointers = pointers.linearize();
+            for (int i = 0; i < size; ++i) {
+                ints_match = ints_match && flat_ints[i] == i;
+                pointers_match = pointers_match && *flat_pointers[i] == i;
+            }
+        }
+    }
+    std::cout << "All wrapped splits linearized in order: ints " << ints_match << ", unique_ptrs " << pointers_match << std::endl;
+    
+    // Inline elements stay in the inline buffer
+    small_cvector<std::string, 8> inline_words;
+    inline_words.push_back("b");
+    inline_words.push_back("c");
+    inline_words.push_front("a");
+    const char* object = reinterpret_cast<const char*>(&inline_words);
+    std::span<std::string> flat_inline = inline_words.linearize();
+    const char* first = reinterpret_cast<const char*>(flat_inline.data());
+    std::cout << "Inline strings linearized: '" << flat_inline[0] << "' '" << flat_inline[1] << "' '" << flat_inline[2]
+              << "', still inline: " << (first >= object && first < object + sizeof(inline_words)) << std::endl;
+}
+
+void test_segmented_algorithms() {
+    std::cout << "\n=== Testing Segmented Algorithms ===" << std::endl;
+    
+    // Wrapped ring: elements cross the end of the buffer
+    cvector<int> vec;
+    vec.reserve(8);
+    for (int i = 4; i <= 8; ++i) {
+        vec.push_back(i);
+    }
+    for (int i = 3; i >= 1; --i) {
+        vec.push_front(i);
+    }
+    
+    auto [head_part, wrapped_part] = vec.begin().segments(vec.end());
+    std::cout << "Segments: " << head_part.size() << "+" << wrapped_part.size() << std::endl;
+    
+    std::cout << "for_each: ";
+    containers::for_each(vec.begin(), vec.end(), [](int elem) { std::cout << elem << " "; });
+    std::cout << std::endl;
+    
+    std::cout << "accumulate: " << containers::accumulate(vec.cbegin(), vec.cend(), 0) << std::endl;
+    
+    auto it = containers::find(vec.begin(), vec.end(), 5);
+    std::cout << "find(5) at position " << (it - vec.begin()) << ", value " << *it << std::endl;
+    std::cout << "find(42) is end: " << (containers::find(vec.begin(), vec.end(), 42) == vec.end()) << std::endl;
+    
+    std::vector<int> doubled(vec.size());
+    containers::transform(vec.begin(), vec.end(), doubled.begin(), [](int elem) { return elem * 2; });
+    std::cout << "transform (x2): ";
+    for (int elem : doubled) {
+        std::cout << elem << " ";
+    }
+    std::cout << std::endl;
+    
+    containers::fill(vec.begin() + 2, vec.end() - 2, 0);
+    std::vector<int> copied;
+    containers::copy(vec.begin(), vec.end(), std::back_inserter(copied));
+    std::cout << "fill middle with 0, then copy: ";
+    for (int elem : copied) {
+        std::cout << elem << " ";
+    }
+    std::cout << std::endl;
+    
+    // Unqualified calls with both namespaces visible: cvector iterators take the segmented overloads,
+    // other iterators (here ones whose value type pulls in containers through ADL) go to std
+    {
+        using namespace std;
+        std::vector<cvector<int>> rings(3);
+        fill(vec.begin(), vec.end(), 2);
+        int total = accumulate(vec.begin(), vec.end(), 0);
+        bool found = find(vec.begin(), vec.end(), 2) == vec.begin();
+        size_t empty_rings = 0;
+        for_each(rings.begin(), rings.end(), [&empty_rings](const cvector<int>& ring) { empty_rings += ring.empty(); });
+        std::cout << "Unqualified with using namespace std: accumulate " << total << ", find " << found
+                  << ", for_each over std::vector of rings " << empty_rings << std::endl;
+    }
+}
+
+void test_spsc_ring() {
+    std::cout << "\n=== Testing SPSC Ring ===" << std::endl;
+    
+    spsc_ring<std::string> single(3);
+    std::cout << "Requested capacity 3, got " << single.capacity() << std::endl;
+    for (int i = 0; i < 5; ++i) {
+        std::cout << "try_push(" << i << ") -> " << single.try_push(std::to_string(i)) << std::endl;
+    }
+    std::string out;
+    while (single.try_pop(out)) {
+        std::cout << "try_pop -> '" << out << "'" << std::endl;
+    }
+    
+    // One producer and one consumer thread passing a million values through a small ring
+    constexpr int count = 1000000;
+    spsc_ring<int> ring(1024);
+    std::thread producer([&ring]() {
+        int batch[64];
+        int next = 0;
+        while (next < count) {
+            int n = std::min(64, count - next);
+            for (int i = 0; i < n; ++i) {
+                batch[i] = next + i;
+            }
+            next += static_cast<int>(ring.push_n(batch, static_cast<size_t>(n)));
+        }
+    });
+    
+    long long sum = 0;
+    int expected = 0;
+    bool in_order = true;
+    int received[64];
+    while (expected < count) {
+        size_t n = ring.pop_n(received, 64);
+        for (size_t i = 0; i < n; ++i) {
+            in_order = in_order && received[i] == expected;
+            sum += received[i];
+            ++expected;
+        }
+    }
+    producer.join();
+    std::cout << "Transferred " << expected << " values, in order: " << in_order << ", sum: " << sum << std::endl;
+}
+
+// copying "bad" throws, moving never does
+struct picky_copy {
+    std::string text;
+    
+    explicit picky_copy(std::string t) : text(std::move(t)) {}
+    picky_copy(const picky_copy& other) : text(other.text) {
+        if (text == "bad") {
+            throw std::runtime_error("copy failed");
+        }
+    }
+    picky_copy(picky_copy&&) noexcept = default;
+    picky_copy& operator=(const picky_copy&) = default;
+    picky_copy& operator=(picky_copy&&) noexcept = default;
+};
+
+void test_mpmc_queue() {
+    std::cout << "\n=== Testing MPMC Queue ===" << std::endl;
+    
+    mpmc_queue<std::string> small(2);
+    std::cout << "try_push a, b, c -> " << small.try_push("a") << small.try_push("b") << small.try_push("c") << std::endl;
+    std::cout << "pop() -> '" << small.pop() << "'" << std::endl;
+    std::cout << "try_push_for(d, 1ms) -> " << small.try_push_for("d", std::chrono::milliseconds(1)) << std::endl;
+    std::vector<std::string> drained;
+    small.pop_n(std::back_inserter(drained), 8);
+    std::cout << "pop_n drained: ";
+    for (const auto& word : drained) {
+        std::cout << "'" << word << "' ";
+    }
+    std::cout << std::endl;
+    std::string out;
+    std::cout << "try_pop_for on empty queue (1ms) -> " << small.try_pop_for(out, std::chrono::milliseconds(1)) << std::endl;
+    
+    // a copy that throws must not leave a claimed slot behind
+    mpmc_queue<picky_copy> picky(2);
+    picky_copy good("good"), bad("bad");
+    try {
+        picky.try_push(bad);
+        std::cout << "ERROR: copy did not throw" << std::endl;
+    } catch (const std::runtime_error& e) {
+        std::cout << "try_push threw '" << e.what() << "', size " << picky.size();
+    }
+    std::cout << ", then try_push good x3 -> " << picky.try_push(good) << picky.try_push(good) << picky.try_push(good);
+    picky_copy popped("");
+    std::cout << ", try_pop -> " << picky.try_pop(popped) << " '" << popped.text << "', size " << picky.size() << std::endl;
+    
+    // Four producers and four consumers sharing one queue
+    constexpr int threads = 4;
+    constexpr int per_producer = 100000;
+    mpmc_queue<int> queue(256);
+    std::vector<std::thread> workers;
+    std::vector<long long> sums(threads, 0);
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&queue, t]() {
+            for (int i = 1; i <= per_producer; ++i) {
+                queue.push(i + t);
+            }
+        });
+        workers.emplace_back([&queue, &sums, t]() {
+            for (int i = 0; i < per_producer; ++i) {
+                sums[t] += queue.pop();
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    long long total = 0;
+    for (long long sum : sums) {
+        total += sum;
+    }
+    long long expected = 0;
+    for (int t = 0; t < threads; ++t) {
+        expected += static_cast<long long>(per_producer) * (per_producer + 1) / 2 + static_cast<long long>(t) * per_producer;
+    }
+    std::cout << "Transferred " << threads * per_producer << " values with " << threads << " producers and "
+              << threads << " consumers, sum matches: " << (total == expected) << std::endl;
+}
+
+void test_allocators() {
+    std::cout << "\n=== Testing Allocators ===" << std::endl;
+    
+    // std::allocator has no reallocate, so growth always takes the allocate + memcpy path
+    cvector<int, std::allocator<int>> std_alloc;
+    for (int i = 0; i < 10; ++i) {
+        std_alloc.push_back(i);
+    }
+    std::cout << "std::allocator: size=" << std_alloc.size() << ", capacity=" << std_alloc.capacity()
+              << ", back() = " << std_alloc.back() << std::endl;
+    
+    // Per-request arena: every allocation is served from a stack buffer
+    std::byte arena[4096];
+    std::pmr::monotonic_buffer_resource resource(arena, sizeof(arena), std::pmr::null_memory_resource());
+    {
+        cvector<int, std::pmr::polymorphic_allocator<int>> numbers(&resource);
+        for (int i = 0; i < 100; ++i) {
+            numbers.push_back(i);
+        }
+        cvector<std::pmr::string, std::pmr::polymorphic_allocator<std::pmr::string>> words(&resource);
+        words.emplace_back("a string long enough to need its own heap allocation");
+        words.emplace_front("another string that does not fit in the small string buffer");
+        std::cout << "pmr arena: numbers size=" << numbers.size() << ", words size=" << words.size()
+                  << ", word uses arena: " << (words.back().get_allocator().resource() == &resource) << std::endl;
+        
+        auto copy = numbers;
+        std::cout << "pmr copy uses default resource: "
+                  << (copy.get_allocator().resource() == std::pmr::get_default_resource()) << std::endl;
+    }
+    std::cout << "Arena served all allocations (null upstream would have thrown)" << std::endl;
+    
+    // mmap-backed rings: trivially copyable elements grow with mremap, others are relocated
+    cvector<long, mmap_allocator<long, huge_pages::transparent>> mapped;
+    for (long i = 0; i < 1000000; ++i) {
+        mapped.push_front(i);
+    }
+    long mapped_sum = 0;
+    for (const auto& elem : mapped) {
+        mapped_sum += elem;
+    }
+    mapped.shrink_to_fit();
+    cvector<std::string, mmap_allocator<std::string>> mapped_words;
+    for (int i = 0; i < 1000; ++i) {
+        mapped_words.emplace_back("word " + std::to_string(i));
+    }
+    std::cout << "mmap_allocator: " << mapped.size() << " longs, sum=" << mapped_sum << ", capacity after shrink=" << mapped.capacity()
+              << ", strings back() = '" << mapped_words.back() << "'" << std::endl;
+}
+
+void test_shrink() {
+    std::cout << "\n=== Testing Shrink ===" << std::endl;
+    
+    // Wrapped trivially copyable ring: unwrapped in place, then shrunk with realloc
+    cvector<int> vec;
+    vec.reserve(64);
+    for (int i = 0; i < 40; ++i) {
+        vec.push_back(i);
+    }
+    for (int i = 0; i < 36; ++i) {
+        vec.pop_front();
+    }
+    for (int i = 40; i < 70; ++i) {
+        vec.push_back(i);
+    }
+    for (int i = 0; i < 30; ++i) {
+        vec.pop_front();
+    }
+    std::cout << "Before shrink_to_fit: size=" << vec.size() << ", capacity=" << vec.capacity()
+              << ", segments " << vec.as_spans().first.size() << "+" << vec.as_spans().second.size() << std::endl;
+    vec.shrink_to_fit();
+    std::cout << "After shrink_to_fit: size=" << vec.size() << ", capacity=" << vec.capacity() << ", elements: ";
+    for (const auto& elem : vec) {
+        std::cout << elem << " ";
+    }
+    std::cout << std::endl;
+    
+    cvector<std::string> words;
+    for (int i = 0; i < 20; ++i) {
+        words.push_back("word " + std::to_string(i));
+    }
+    words.clear();
+    words.shrink_to_fit();
+    std::cout << "Cleared strings after shrink_to_fit: capacity=" << words.capacity() << std::endl;
+    
+    // Automatic shrinking with hysteresis
+    cvector<int> burst;
+    burst.set_auto_shrink(true, 8);
+    for (int i = 0; i < 1000; ++i) {
+        burst.push_back(i);
+    }
+    std::cout << "Auto shrink: after burst capacity=" << burst.capacity();
+    while (burst.size() > 100) {
+        burst.pop_front();
+    }
+    std::cout << ", at 100 elements capacity=" << burst.capacity();
+    while (!burst.empty()) {
+        burst.pop_back();
+    }
+    std::cout << ", drained capacity=" << burst.capacity() << std::endl;
+    
+    // The shrink policy is assigned along with the elements
+    cvector<int> assigned;
+    for (int i = 0; i < 1000; ++i) {
+        burst.push_back(i);
+    }
+    assigned = burst;
+    while (assigned.size() > 10) {
+        assigned.pop_back();
+    }
+    std::cout << "Auto shrink after copy assignment: capacity=" << assigned.capacity();
+    cvector<int> moved;
+    moved = std::move(burst);
+    while (moved.size() > 10) {
+        moved.pop_back();
+    }
+    std::cout << ", after move assignment: capacity=" << moved.capacity() << std::endl;
+}
+
+void test_small_buffer() {
+    std::cout << "\n=== Testing Small Buffer ===" << std::endl;
+    
+    // Up to 8 elements live inside the object, the 9th spills to the heap
+    small_cvector<int, 8> small;
+    std::cout << "Empty small_cvector<int, 8>: capacity=" << small.capacity() << ", sizeof=" << sizeof(small) << std::endl;
+    const int* inline_address = &small.emplace_back(0);
+    for (int i = 1; i < 8; ++i) {
+        small.push_front(-i);
+    }
+    std::cout << "8 elements: capacity=" << small.capacity() << ", still inline: " << (&small.back() == inline_address) << std::endl;
+    small.push_back(8);
+    std::cout << "9 elements: capacity=" << small.capacity() << ", elements: ";
+    for (const auto& elem : small) {
+        std::cout << elem << " ";
+    }
+    std::cout << std::endl;
+    for (int i = 0; i < 5; ++i) {
+        small.pop_front();
+    }
+    small.shrink_to_fit();
+    std::cout << "After pops and shrink_to_fit: capacity=" << small.capacity()
+              << ", back in inline buffer: " << (&small.front() >= inline_address - 7 && &small.front() <= inline_address) << std::endl;
+    
+    // Non-trivial elements are moved between inline buffers
+    small_cvector<std::string, 4> words;
+    words.push_back("a string long enough to need its own heap allocation");
+    words.push_front("short");
+    small_cvector<std::string, 4> moved = std::move(words);
+    std::cout << "Moved inline strings: source size=" << words.size() << ", target: '" << moved.front() << "', '" << moved.back() << "'" << std::endl;
+    
+    small_cvector<std::string, 4> spilled;
+    for (int i = 0; i < 6; ++i) {
+        spilled.push_back("word " + std::to_string(i));
+    }
+    swap(moved, spilled);
+    std::cout << "Swapped inline and heap: sizes " << moved.size() << " and " << spilled.size()
+              << ", capacities " << moved.capacity() << " and " << spilled.capacity() << std::endl;
+    
+    small_cvector<std::string, 4> copy = spilled;
+    copy.emplace_front("copied");
+    std::cout << "Copy of inline vector: ";
+    for (const auto& elem : copy) {
+        std::cout << "'" << elem << "' ";
+    }
+    std::cout << std::endl;
+}
+
+void test_growth() {
+    std::cout << "\n=== Testing Growth ===" << std::endl;
+    
+    // Growth policy: the first allocation already holds 16 elements
+    cvector<int, malloc_allocator<int>, 0, doubling_growth<16>> sized;
+    sized.push_back(1);
+    cvector<char, malloc_allocator<char>, 0, cache_line_growth<char>> bytes;
+    bytes.push_front('x');
+    std::cout << "doubling_growth<16> after one push: capacity=" << sized.capacity()
+              << ", cache_line_growth<char>: capacity=" << bytes.capacity() << std::endl;
+    
+    cvector<int> plain;
+    size_t reallocations = 0;
+    for (int i = 0; i < 1000000; ++i) {
+        size_t capacity = plain.capacity();
+        plain.push_back(i);
+        reallocations += plain.capacity() != capacity;
+    }
+    cvector<int, malloc_allocator<int>, 0, doubling_growth<1024>> presized;
+    size_t presized_reallocations = 0;
+    for (int i = 0; i < 1000000; ++i) {
+        size_t capacity = presized.capacity();
+        presized.push_back(i);
+        presized_reallocations += presized.capacity() != capacity;
+    }
+    std::cout << "Growth steps to 1M elements: doubling from 1: " << reallocations
+              << ", from 1024: " << presized_reallocations << std::endl;
+    
+    // Wrapped rings grow with realloc, then the shorter run is copied into the new space
+    for (int wrapped : {2, 6}) {
+        cvector<int> ring;
+        ring.reserve(8);
+        for (int i = 0; i < 8 - wrapped; ++i) {
+            ring.push_back(0);
+        }
+        for (int i = 0; i < 8 - wrapped; ++i) {
+            ring.pop_front();
+        }
+        for (int i = 0; i < 8; ++i) {
+            ring.push_back(i);
+        }
+        ring.push_back(8);
+        std::cout << "Grown ring with " << wrapped << " wrapped elements: capacity=" << ring.capacity() << ", elements: ";
+        for (const auto& elem : ring) {
+            std::cout << elem << " ";
+        }
+        std::cout << std::endl;
+    }
+}
+
+void test_mirrored() {
+    std::cout << "\n=== Testing Mirrored Ring ===" << std::endl;
+    
+    // Log batching: records wrap around the end of the buffer but stay contiguous
+    cvector<char, mirrored_allocator<char>> log;
+    log.reserve(1);
+    size_t capacity = log.capacity();
+    std::cout << "Smallest mirrored char ring: capacity=" << capacity << " (one page)" << std::endl;
+    for (size_t i = 0; i < capacity - 8; ++i) {
+        log.push_back('.');
+    }
+    for (size_t i = 0; i < capacity - 8; ++i) {
+        log.pop_front();
+    }
+    std::string record = "record crossing the end of the buffer";
+    log.append(record.begin(), record.end());
+    auto [first, second] = log.as_spans();
+    std::span<char> batch = log.linearize();
+    std::cout << "Wrapped record: segments " << first.size() << "+" << second.size()
+              << ", linearize kept head in place: " << (batch.data() == first.data())
+              << ", contents: '" << std::string(batch.begin(), batch.end()) << "'" << std::endl;
+    
+    // Growing a wrapped mirrored ring keeps the order
+    cvector<int, mirrored_allocator<int>> numbers;
+    for (int i = 0; i < 1000; ++i) {
+        numbers.push_back(i);
+    }
+    for (int i = 0; i < 600; ++i) {
+        numbers.pop_front();
+    }
+    for (int i = 1000; i < 2000; ++i) {
+        numbers.push_back(i);
+    }
+    long long sum = accumulate(numbers.begin(), numbers.end(), 0LL);
+    std::cout << "Mirrored int ring: size=" << numbers.size() << ", capacity=" << numbers.capacity()
+              << ", numbers[0]=" << numbers[0] << ", back()=" << numbers.back() << ", sum=" << sum << std::endl;
+}
+
+void test_mapped() {
+    std::cout << "\n=== Testing Mapped cvector ===" << std::endl;
+    
+    std::string path = (std::filesystem::temp_directory_path() / "test_mapped_cvector.ring").string();
+    std::filesystem::remove(path);
+    
+    {
+        mapped_cvector<long> queue(path);
+        std::cout << "Created: size=" << queue.size() << ", capacity=" << queue.capacity() << std::endl;
+        for (long i = 0; i < 1000; ++i) {
+            queue.push_back(i);
+        }
+        queue.pop_front(400);
+        // the batch wraps around the end of the file, then the wrapped ring grows
+        std::vector<long> batch(300);
+        std::iota(batch.begin(), batch.end(), 1000);
+        queue.append(batch.begin(), batch.end());
+        for (long i = 1300; i < 1700; ++i) {
+            queue.push_back(i);
+        }
+        queue.push_front(-1);
+        queue.flush();
+        std::cout << "Before close: size=" << queue.size() << ", capacity=" << queue.capacity()
+                  << ", front()=" << queue.front() << ", back()=" << queue.back() << std::endl;
+    }
+    
+    {
+        // Reopened without reading the elements back
+        mapped_cvector<long> queue(path);
+        long long sum = std::accumulate(queue.begin(), queue.end(), 0LL);
+        std::span<long> contents = queue.linearize();
+        std::cout << "Reopened: size=" << queue.size() << ", capacity=" << queue.capacity() << ", queue[1]=" << queue[1]
+                  << ", sum=" << sum << ", one contiguous span of " << contents.size() << std::endl;
+        queue.clear();
+    }
+    
+    try {
+        mapped_cvector<int> wrong_type(path);
+        std::cout << "ERROR: opened a ring of longs as ints" << std::endl;
+    } catch (const std::runtime_error& e) {
+        std::cout << "Opening with the wrong element type throws: " << e.what() << std::endl;
+    }
+    std::filesystem::remove(path);
+    
+    // a file that is not empty but holds no ring is left alone
+    {
+        std::ofstream zeros(path, std::ios::binary);
+        zeros << std::string(4096, '\0');
+    }
+    try {
+        mapped_cvector<long> zeroed(path);
+        std::cout << "ERROR: opened a file of zeros as a ring" << std::endl;
+    } catch (const std::runtime_error& e) {
+        std::cout << "Opening a file of zeros throws, file size still " << std::filesystem::file_size(path) << std::endl;
+    }
+    std::filesystem::remove(path);
+}
+
+template <typename Vector, typename Make>
+bool matches_deque_after_random_edits(Make make) {
+    Vector vec;
+    std::deque<typename Vector::iterator::value_type> reference;
+    std::mt19937 rng(42);
+    for (int step = 0; step < 2000; ++step) {
+        size_t index = reference.empty() ? 0 : rng() % (reference.size() + 1);
+        switch (rng() % 4) {
+            case 0:
+                vec.insert(vec.begin() + index, make(step));
+                reference.insert(reference.begin() + index, make(step));
+                break;
+            case 1: {
+                std::vector<typename Vector::iterator::value_type> range;
+                // not empty: std::deque of GCC 12 self-move-assigns elements when inserting an empty range
+                for (size_t i = 1 + rng() % 5; i > 0; --i) {
+                    range.push_back(make(step * 8 + static_cast<int>(i)));
+                }
+                vec.insert(vec.begin() + index, range.begin(), range.end());
+                reference.insert(reference.begin() + index, range.begin(), range.end());
+                break;
+            }
+            case 2:
+                if (index < reference.size()) {
+                    vec.erase(vec.begin() + index);
+                    reference.erase(reference.begin() + index);
+                }
+                break;
+            default: {
+                size_t count = std::min<size_t>(rng() % 4, reference.size() - std::min(index, reference.size()));
+                vec.erase(vec.begin() + index, vec.begin() + index + count);
+                reference.erase(reference.begin() + index, reference.begin() + index + count);
+            }
+        }
+    }
+    return vec.size() == reference.size() && std::equal(vec.begin(), vec.end(), reference.begin());
+}
+
+void test_insert_erase() {
+    std::cout << "\n=== Testing Insert and Erase ===" << std::endl;
+    
+    cvector<int> vec;
+    for (int i = 0; i < 10; ++i) {
+        vec.push_back(i);
+    }
+    // Near the front only the front elements move, so head moves with them
+    const int* last_address = &vec.back();
+    vec.erase(vec.begin() + 2);
+    vec.insert(vec.begin() + 1, 100);
+    std::cout << "Front-side edits: back element stayed in place: " << (&vec.back() == last_address) << std::endl;
+    const int* first_address = &vec.front();
+    vec.erase(vec.end() - 3, vec.end() - 1);
+    auto it = vec.emplace(vec.end() - 1, 200);
+    std::cout << "Back-side edits: front element stayed in place: " << (&vec.front() == first_address)
+              << ", emplaced " << *it << ", elements: ";
+    for (const auto& elem : vec) {
+        std::cout << elem << " ";
+    }
+    std::cout << std::endl;
+    
+    std::cout << "Random edits match std::deque: ints " << matches_deque_after_random_edits<cvector<int>>([](int i) { return i; })
+              << ", strings " << matches_deque_after_random_edits<cvector<std::string>>([](int i) { return "value " + std::to_string(i); })
+              << std::endl;
+}
+
+void print_stats(const cvector_stats_snapshot& s) {
+    std::cout << "  '" << s.label << "': grows=" << s.grow_events << ", shrinks=" << s.shrink_events
+              << ", in place=" << s.in_place_relocations << ", copied=" << s.copy_relocations << " (" << s.bytes_copied << " bytes)"
+              << ", wraps=" << s.wraps << ", capacity=" << s.capacity_bytes << "B, peak=" << s.peak_capacity_bytes << "B" << std::endl;
+}
+
+void test_stats() {
+    std::cout << "\n=== Testing Stats ===" << std::endl;
+    
+    using counted_ints = cvector<int, malloc_allocator<int>, 0, doubling_growth<>, cvector_stats>;
+    using counted_strings = cvector<std::string, malloc_allocator<std::string>, 0, doubling_growth<>, cvector_stats>;
+    std::cout << "Stats disabled by default, sizeof(cvector<int>)=" << sizeof(cvector<int>) << std::endl;
+    
+    counted_ints queue;
+    queue.stats().set_label("int queue");
+    for (int i = 0; i < 100; ++i) {
+        queue.push_back(i);
+    }
+    for (int round = 0; round < 500; ++round) {
+        queue.pop_front();
+        queue.push_back(round);
+    }
+    {
+        counted_strings words;
+        words.stats().set_label("strings");
+        for (int i = 0; i < 100; ++i) {
+            words.push_front("word " + std::to_string(i));
+        }
+        words.clear();
+        words.shrink_to_fit();
+        
+        std::cout << "Live rings:" << std::endl;
+        cvector_stats_registry::instance().for_each(print_stats);
+    }
+    cvector_stats_snapshot retired = cvector_stats_registry::instance().retired();
+    std::cout << "After the string ring is destroyed: retired grows=" << retired.grow_events
+              << ", retired peak=" << retired.peak_capacity_bytes << "B" << std::endl;
+    
+    // bulk append/prepend and pop_back count the same wraps as the equivalent single-element operations
+    counted_ints bulk, single;
+    for (counted_ints* ring : {&bulk, &single}) {
+        ring->reserve(8);
+        for (int i = 0; i < 6; ++i) {
+            ring->push_back(i);
+        }
+        for (int i = 0; i < 4; ++i) {
+            ring->pop_front();
+        }
+    }
+    int values[] = {6, 7, 8, 9, 10};
+    bulk.append(values, values + 4);
+    for (int i = 0; i < 4; ++i) {
+        single.push_back(values[i]);
+    }
+    for (counted_ints* ring : {&bulk, &single}) {
+        for (int i = 0; i < 3; ++i) {
+            ring->pop_back();
+        }
+    }
+    bulk.prepend(values, values + 5);
+    for (int i = 5; i-- > 0;) {
+        single.push_front(values[i]);
+    }
+    std::cout << "Wraps after append, pop_back and prepend across the buffer ends: bulk " << bulk.stats().snapshot().wraps
+              << ", one at a time " << single.stats().snapshot().wraps << ", same elements "
+              << std::equal(bulk.begin(), bulk.end(), single.begin(), single.end()) << std::endl;
+}
+
+void test_checked_access() {
+    std::cout << "\n=== Testing Checked Access ===" << std::endl;
+    
+    cvector<int> vec;
+    for (int i = 0; i < 8; ++i) {
+        vec.push_back(i);
+    }
+    vec.pop_front();
+    vec.push_back(8);
+    std::cout << "at(0)=" << vec.at(0) << ", at(7)=" << vec.at(7) << std::endl;
+    
+    try {
+        vec.at(8);
+        std::cout << "ERROR: at(8) did not throw" << std::endl;
+    } catch (const std::out_of_range& e) {
+        std::cout << "at(8) threw: " << e.what() << std::endl;
+    }
+    const cvector<int>& view = vec;
+    try {
+        view.at(100);
+        std::cout << "ERROR: const at(100) did not throw" << std::endl;
+    } catch (const std::out_of_range& e) {
+        std::cout << "const at(100) threw: " << e.what() << std::endl;
+    }
+    
+    // without CVECTOR_HARDENED the iterators carry no generation and stay the size of an index and a pointer
+    std::cout << "Hardened mode: " << (cvector_hardened ? "on" : "off")
+              << ", sizeof(cvector<int>::iterator)=" << sizeof(cvector<int>::iterator) << std::endl;
+}
+
+// counts move constructions, to see which operations relocate it by memcpy
+struct relocatable_tracker {
+    static inline int moves = 0;
+    std::unique_ptr<int> value;
+    
+    explicit relocatable_tracker(int v) : value(std::make_unique<int>(v)) {}
+    relocatable_tracker(relocatable_tracker&& other) noexcept : value(std::move(other.value)) { ++moves; }
+    relocatable_tracker& operator=(relocatable_tracker&& other) noexcept {
+        value = std::move(other.value);
+        ++moves;
+        return *this;
+    }
+};
+
+template <>
+struct containers::is_trivially_relocatable<relocatable_tracker> : std::true_type {};
+
+void test_relocatable() {
+    std::cout << "\n=== Testing Trivially Relocatable ===" << std::endl;
+    
+    std::cout << "is_trivially_relocatable: unique_ptr=" << is_trivially_relocatable_v<std::unique_ptr<int>>
+              << ", vector=" << is_trivially_relocatable_v<std::vector<int>>
+              << ", string=" << is_trivially_relocatable_v<std::string>
+              << ", cvector<int>=" << is_trivially_relocatable_v<cvector<int>>
+              << ", small_cvector<int, 4>=" << is_trivially_relocatable_v<small_cvector<int, 4>> << std::endl;
+    
+    // wrapped ring grown, unwrapped, shrunk and edited in the middle without a single move constructor call
+    cvector<relocatable_tracker> vec;
+    for (int i = 0; i < 6; ++i) {
+        vec.emplace_back(i);
+    }
+    for (int i = 1; i <= 3; ++i) {
+        vec.emplace_front(-i);
+    }
+    for (int i = 6; i < 40; ++i) {
+        vec.emplace_back(i);
+    }
+    // the only moves are of the new element that triggered each growth, built before the buffer is replaced
+    int growths = std::bit_width(vec.capacity());
+    vec.pop_front();
+    vec.emplace_front(-100);
+    vec.linearize();
+    vec.erase(vec.begin() + 5, vec.begin() + 8);
+    vec.erase(vec.end() - 4);
+    for (int i = 0; i < 30; ++i) {
+        vec.pop_back();
+    }
+    vec.shrink_to_fit();
+    std::cout << "Moves during growth, linearize, erase and shrink: " << relocatable_tracker::moves
+              << " (growths: " << growths << ")" << std::endl;
+    std::cout << "Contents:";
+    for (const auto& item : vec) {
+        std::cout << " " << *item.value;
+    }
+    std::cout << " (capacity " << vec.capacity() << ")" << std::endl;
+    
+    // nested cvectors keep their heap buffers when the outer ring grows
+    cvector<cvector<int>> nested;
+    for (int i = 0; i < 100; ++i) {
+        cvector<int> inner;
+        for (int j = 0; j <= i % 5; ++j) {
+            inner.push_back(i * 10 + j);
+        }
+        nested.push_front(std::move(inner));
+    }
+    cvector<int> sevens;
+    for (int j = 0; j < 3; ++j) {
+        sevens.push_back(7);
+    }
+    nested.insert(nested.begin() + 50, std::move(sevens));
+    size_t total = 0;
+    for (const auto& inner : nested) {
+        for (int value : inner) {
+            total += static_cast<size_t>(value);
+        }
+    }
+    std::cout << "Nested cvector: " << nested.size() << " rings, sum " << total << std::endl;
+}
+
+// copy and move constructors that can throw, to check that failed growth leaves the ring untouched
+struct fragile {
+    static inline int copies = 0;
+    static inline int copies_until_throw = -1;
+    std::string text;
+    
+    explicit fragile(std::string t) : text(std::move(t)) {}
+    fragile(const fragile& other) : text(other.text) {
+        if (copies_until_throw >= 0 && copies++ >= copies_until_throw) {
+            throw std::runtime_error("copy failed");
+        }
+    }
+    // not noexcept, so growth copies instead of moving
+    fragile(fragile&& other) : text(std::move(other.text)) {}
+    fragile& operator=(const fragile&) = default;
+    fragile& operator=(fragile&&) = default;
+};
+
+void test_exception_safety() {
+    std::cout << "\n=== Testing Exception Safety ===" << std::endl;
+    
+    cvector<fragile> vec;
+    for (int i = 0; i < 4; ++i) {
+        vec.emplace_back("item " + std::to_string(i));
+    }
+    // wrap the ring so the relocation has to unwrap it as well
+    vec.pop_front();
+    vec.emplace_back("item 4");
+    
+    fragile::copies = 0;
+    fragile::copies_until_throw = 2;
+    try {
+        vec.emplace_back("item 5");
+        std::cout << "ERROR: growth did not throw" << std::endl;
+    } catch (const std::runtime_error& e) {
+        std::cout << "Growth threw '" << e.what() << "' after " << fragile::copies << " copies" << std::endl;
+    }
+    fragile::copies_until_throw = -1;
+    std::cout << "After failed growth: size " << vec.size() << ", capacity " << vec.capacity() << ":";
+    for (const auto& item : vec) {
+        std::cout << " [" << item.text << "]";
+    }
+    std::cout << std::endl;
+    
+    vec.emplace_back("item 5");
+    std::cout << "Retry succeeded: size " << vec.size() << ", back [" << vec.back().text << "]" << std::endl;
+    
+    // automatic shrinking gives up quietly when a copy throws
+    cvector<fragile> shrinking;
+    shrinking.set_auto_shrink(true, 4);
+    for (int i = 0; i < 32; ++i) {
+        shrinking.emplace_back(std::to_string(i));
+    }
+    fragile::copies = 0;
+    fragile::copies_until_throw = 0;
+    for (int i = 0; i < 28; ++i) {
+        shrinking.pop_back();
+    }
+    fragile::copies_until_throw = -1;
+    std::cout << "Auto shrink with failing copies: size " << shrinking.size() << ", capacity " << shrinking.capacity()
+              << ", front [" << shrinking.front().text << "]" << std::endl;
+    
+    // A batch push that fails partway leaves nothing behind in the ring
+    spsc_ring<fragile> ring(8);
+    std::vector<fragile> batch;
+    for (int i = 0; i < 6; ++i) {
+        batch.emplace_back("a batch element long enough to live on the heap " + std::to_string(i));
+    }
+    fragile::copies = 0;
+    fragile::copies_until_throw = 3;
+    try {
+        ring.push_n(batch.begin(), batch.size());
+        std::cout << "ERROR: push_n did not throw" << std::endl;
+    } catch (const std::runtime_error& e) {
+        std::cout << "spsc_ring::push_n threw after " << fragile::copies << " copies, size " << ring.size();
+    }
+    fragile::copies_until_throw = -1;
+    size_t pushed = ring.push_n(batch.begin(), batch.size());
+    fragile out("");
+    ring.try_pop(out);
+    std::cout << ", retry pushed " << pushed << ", front [" << out.text.substr(out.text.size() - 1) << "]" << std::endl;
+}
+
+// the second run of a wrapped ring starts at the beginning of the buffer, so only wrapped rings are checked
+template <typename Vec>
+void check_buffer_alignment(const Vec& vec, bool& aligned, int& checked) {
+    auto [first, second] = vec.as_spans();
+    if (!second.empty()) {
+        aligned = aligned && reinterpret_cast<uintptr_t>(second.data()) % Vec::alignment == 0;
+        ++checked;
+    }
+}
+
+struct alignas(128) wide_slot {
+    float lanes[32];
+};
+
+void test_aligned() {
+    std::cout << "\n=== Testing Aligned Storage ===" << std::endl;
+    
+    // 24 byte elements on 64 byte boundaries: block sizes are rounded up for aligned_alloc
+    struct triple {
+        double x, y, z;
+    };
+    aligned_cvector<triple> vec;
+    bool aligned = true;
+    int checked = 0;
+    for (int i = 0; i < 1000; ++i) {
+        vec.push_front({double(i), 0, 0});
+        if (i % 3 == 0) {
+            vec.pop_back();
+        }
+        check_buffer_alignment(vec, aligned, checked);
+    }
+    for (int i = 0; i < 600; ++i) {
+        vec.pop_back();
+    }
+    vec.shrink_to_fit();
+    vec.push_front({-1, 0, 0});
+    check_buffer_alignment(vec, aligned, checked);
+    std::cout << "aligned_cvector<24 byte struct>: alignment " << decltype(vec)::alignment << ", size " << vec.size()
+              << ", capacity " << vec.capacity() << ", " << checked << " wrapped states aligned: " << aligned << std::endl;
+    
+    // over-aligned type with the default allocator, growing through non-trivial relocation
+    cvector<wide_slot> wide;
+    aligned = true;
+    checked = 0;
+    for (int i = 0; i < 100; ++i) {
+        wide.push_front(wide_slot{{float(i)}});
+        check_buffer_alignment(wide, aligned, checked);
+    }
+    std::cout << "cvector<alignas(128) struct>: alignment " << decltype(wide)::alignment << ", " << checked
+              << " wrapped states aligned: " << aligned << ", front " << wide.front().lanes[0] << std::endl;
+    
+    // the inline buffer follows the allocator's alignment too
+    cvector<float, malloc_allocator<float, 64>, 16> small;
+    aligned = true;
+    checked = 0;
+    small.push_back(0.0f);
+    small.push_front(-1.0f);
+    check_buffer_alignment(small, aligned, checked);
+    for (int i = 0; i < 16; ++i) {
+        small.push_front(float(i));
+    }
+    check_buffer_alignment(small, aligned, checked);
+    std::cout << "small aligned cvector: inline and heap buffers (" << checked << " checked) aligned: " << aligned << std::endl;
+}
+
+// checks every cvector_simd kernel against the std algorithms on windows of a wrapped ring
+// the values are small integers, so float sums and dot products are exact in any order
+template <typename T>
+bool simd_matches_std() {
+    cvector<T> ring;
+    std::vector<T> weights;
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> value(-10, 10);
+    for (int i = 0; i < 3000; ++i) {
+        ring.push_back(static_cast<T>(value(rng)));
+    }
+    for (int i = 0; i < 1000; ++i) {
+        ring.pop_front();
+        ring.push_back(static_cast<T>(value(rng)));
+    }
+    for (size_t i = 0; i < ring.size(); ++i) {
+        weights.push_back(static_cast<T>(value(rng)));
+    }
+    bool ok = true;
+    for (int trial = 0; trial < 200; ++trial) {
+        size_t begin = rng() % ring.size();
+        size_t end = begin + rng() % (ring.size() - begin + 1);
+        auto first = ring.cbegin() + static_cast<std::ptrdiff_t>(begin);
+        auto last = ring.cbegin() + static_cast<std::ptrdiff_t>(end);
+        ok = ok && cvector_simd::sum(first, last) == std::accumulate(first, last, T{});
+        ok = ok && cvector_simd::dot(first, last, weights.data()) ==
+                       std::inner_product(first, last, weights.begin(), T{});
+        ok = ok && cvector_simd::dot(first, last, ring.cbegin()) == std::inner_product(first, last, ring.cbegin(), T{});
+        ok = ok && cvector_simd::find(first, last, T(7)) == std::find(first, last, T(7));
+        ok = ok && cvector_simd::find_greater_equal(first, last, T(9)) ==
+                       std::find_if(first, last, [](T x) { return x >= T(9); });
+        if (first != last) {
+            ok = ok && cvector_simd::min(first, last) == *std::min_element(first, last);
+            ok = ok && cvector_simd::max(first, last) == *std::max_element(first, last);
+        }
+    }
+    cvector<T> scaled = ring;
+    cvector_simd::scale_add(scaled.begin(), scaled.end(), T(3), T(1));
+    for (size_t i = 0; i < ring.size(); ++i) {
+        ok = ok && scaled[i] == ring[i] * T(3) + T(1);
+    }
+    return ok;
+}
+
+void test_simd() {
+    std::cout << "\n=== Testing SIMD Kernels ===" << std::endl;
+    
+    const char* names[] = {"scalar", "sse2", "avx2", "avx512"};
+    cvector_simd::isa best = cvector_simd::detect();
+    std::cout << "Widest instruction set: " << names[static_cast<int>(best)] << std::endl;
+    for (auto level : {cvector_simd::isa::scalar, cvector_simd::isa::sse2, cvector_simd::isa::avx2, cvector_simd::isa::avx512}) {
+        if (level > best) {
+            continue;
+        }
+        cvector_simd::use(level);
+        std::cout << "  " << names[static_cast<int>(level)] << ": float " << simd_matches_std<float>() << ", double "
+                  << simd_matches_std<double>() << ", int32 " << simd_matches_std<int32_t>() << ", int64 "
+                  << simd_matches_std<int64_t>() << ", uint32 " << simd_matches_std<uint32_t>() << std::endl;
+    }
+    cvector_simd::use(best);
+    
+    try {
+        cvector<float> empty;
+        cvector_simd::min(empty.begin(), empty.end());
+        std::cout << "ERROR: min of an empty range did not throw" << std::endl;
+    } catch (const std::out_of_range& e) {
+        std::cout << "Empty range: " << e.what() << std::endl;
+    }
+}
+
+// counts the samples above a threshold, as an example of a user aggregate
+struct above_threshold {
+    int count = 0;
+    
+    void push(int value) { count += value > 50; }
+    void pop(int value) { count -= value > 50; }
+    void clear() { count = 0; }
+};
+
+// fails on negative samples after its sum has already taken them
+struct partial_sum {
+    int sum = 0;
+    int count = 0;
+    
+    void push(int value) {
+        sum += value;
+        if (value < 0) {
+            throw std::invalid_argument("negative sample");
+        }
+        ++count;
+    }
+    void pop(int value) { sum -= value; --count; }
+    void clear() { sum = 0; count = 0; }
+};
+
+void test_windowed() {
+    std::cout << "\n=== Testing Windowed cvector ===" << std::endl;
+    
+    // every statistic checked against a recomputation over the window after each sample
+    windowed_cvector<double> window(64);
+    std::mt19937 rng(11);
+    std::normal_distribution<double> sample(100.0, 15.0);
+    double worst_mean = 0, worst_variance = 0;
+    bool extremes_match = true;
+    for (int i = 0; i < 10000; ++i) {
+        window.push_back(sample(rng));
+        double mean = std::accumulate(window.begin(), window.end(), 0.0) / window.size();
+        double variance = 0;
+        for (double x : window) {
+            variance += (x - mean) * (x - mean);
+        }
+        variance /= window.size();
+        const auto& stats = window.aggregates();
+        worst_mean = std::max(worst_mean, std::abs(stats.mean() - mean));
+        worst_variance = std::max(worst_variance, std::abs(stats.variance() - variance) / variance);
+        extremes_match = extremes_match && stats.min() == *std::min_element(window.begin(), window.end()) &&
+                         stats.max() == *std::max_element(window.begin(), window.end());
+    }
+    std::cout << "10000 samples, window " << window.window() << ": min/max exact " << extremes_match
+              << ", worst mean error " << worst_mean << ", worst relative variance error " << worst_variance << std::endl;
+    const auto& stats = window.aggregates();
+    std::cout << "Last window: size " << window.size() << ", mean " << stats.mean() << ", stddev " << std::sqrt(stats.variance())
+              << ", min " << stats.min() << ", max " << stats.max() << std::endl;
+    
+    // unbounded window drained by hand, with a decreasing run that empties the min queue repeatedly
+    windowed_cvector<int, window_min<int>> lows;
+    for (int i = 10; i > 0; --i) {
+        lows.push_back(i);
+    }
+    lows.push_back(5);
+    std::cout << "window_min:";
+    while (!lows.empty()) {
+        std::cout << " " << lows.aggregates().value();
+        lows.pop_front();
+    }
+    std::cout << std::endl;
+    try {
+        lows.aggregates().value();
+        std::cout << "ERROR: empty window_min did not throw" << std::endl;
+    } catch (const std::out_of_range& e) {
+        std::cout << "Empty window: " << e.what() << std::endl;
+    }
+    
+    windowed_cvector<int, above_threshold> counted(10);
+    for (int i = 0; i < 100; i += 7) {
+        counted.push_back(i);
+    }
+    std::cout << "User aggregate: " << counted.aggregates().count << " of the last " << counted.size() << " samples above 50" << std::endl;
+    
+    // a failed push leaves aggregates that match the remaining elements
+    windowed_cvector<int, partial_sum> summed(4);
+    for (int i = 1; i <= 6; ++i) {
+        summed.push_back(i);
+    }
+    try {
+        summed.push_back(-1);
+        std::cout << "ERROR: push_back did not throw" << std::endl;
+    } catch (const std::invalid_argument& e) {
+        std::cout << "After a failed push: " << summed.size() << " elements summing to "
+                  << std::accumulate(summed.begin(), summed.end(), 0) << ", aggregate sum " << summed.aggregates().sum
+                  << ", count " << summed.aggregates().count << std::endl;
+    }
+}
+
 int main() {
     try {
         std::cout << "Testing cvector with C++23 modules!" << std::endl;
@@ -175,6 +1466,27 @@ int main() {
         test_iterator_stability();
         test_pop_operations();
         test_algorithms();
+        test_move_and_emplace();
+        test_copy_move_swap();
+        test_bulk_operations();
+        test_spans();
+        test_segmented_algorithms();
+        test_spsc_ring();
+        test_mpmc_queue();
+        test_allocators();
+        test_shrink();
+        test_small_buffer();
+        test_growth();
+        test_mirrored();
+        test_mapped();
+        test_insert_erase();
+        test_stats();
+        test_checked_access();
+        test_relocatable();
+        test_exception_safety();
+        test_aligned();
+        test_simd();
+        test_windowed();
         
         std::cout << "\n=== All tests completed successfully! ===" << std::endl;
         
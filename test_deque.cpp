@@ -0,0 +1,155 @@
+#include <iostream>
+#include <algorithm>
+#include <string>
+import deque;
+
+using namespace containers;
+
+void test_basic_operations() {
+    std::cout << "=== Testing Basic Operations ===" << std::endl;
+
+    deque<int> dq;
+    std::cout << "Empty deque: size=" << dq.size() << ", nodes=" << dq.node_count()
+              << ", node capacity=" << deque<int>::node_capacity() << std::endl;
+
+    dq.push_back(10);
+    dq.push_back(20);
+    dq.push_front(5);
+    dq.push_front(1);
+    std::cout << "Elements: ";
+    for (size_t i = 0; i < dq.size(); ++i) {
+        std::cout << dq[i] << " ";
+    }
+    std::cout << std::endl;
+    std::cout << "front() = " << dq.front() << ", back() = " << dq.back() << std::endl;
+
+    dq.pop_front();
+    dq.pop_back();
+    std::cout << "After pop_front/pop_back: ";
+    for (const auto& elem : dq) {
+        std::cout << elem << " ";
+    }
+    std::cout << std::endl;
+}
+
+void test_reference_stability() {
+    std::cout << "\n=== Testing Reference Stability ===" << std::endl;
+
+    deque<std::string> words;
+    words.push_back("anchor");
+    std::string& anchor = words.front();
+    const std::string* address = &anchor;
+
+    // Grow across many nodes at both ends
+    for (int i = 0; i < 1000; ++i) {
+        words.push_back("back " + std::to_string(i));
+        words.push_front("front " + std::to_string(i));
+    }
+    std::cout << "After 2000 pushes: size=" << words.size() << ", nodes=" << words.node_count() << std::endl;
+    std::cout << "Reference still valid: " << (&words[1000] == address) << ", value: '" << anchor << "'" << std::endl;
+
+    for (int i = 0; i < 1000; ++i) {
+        words.pop_front();
+    }
+    std::cout << "After 1000 pop_front: front() = '" << words.front() << "', same object: " << (&words.front() == address) << std::endl;
+}
+
+void test_node_reuse() {
+    std::cout << "\n=== Testing Node Reuse ===" << std::endl;
+
+    // FIFO churn: nodes freed at the front are recycled at the back
+    deque<int> queue;
+    for (int i = 0; i < 1000; ++i) {
+        queue.push_back(i);
+    }
+    size_t nodes = queue.node_count();
+    long long sum = 0;
+    for (int i = 1000; i < 100000; ++i) {
+        sum += queue.front();
+        queue.pop_front();
+        queue.push_back(i);
+    }
+    std::cout << "Node count before churn: " << nodes << ", after: " << queue.node_count() << ", sum: " << sum << std::endl;
+
+    queue.clear();
+    queue.shrink_to_fit();
+    std::cout << "After clear/shrink_to_fit: size=" << queue.size() << ", nodes=" << queue.node_count() << std::endl;
+}
+
+void test_copy_and_algorithms() {
+    std::cout << "\n=== Testing Copy and Algorithms ===" << std::endl;
+
+    deque<int> dq;
+    for (int i : {5, 2, 8, 1, 9, 3}) {
+        dq.push_front(i);
+    }
+    deque<int> copy = dq;
+    std::sort(copy.begin(), copy.end());
+    std::cout << "Original: ";
+    for (const auto& elem : dq) {
+        std::cout << elem << " ";
+    }
+    std::cout << std::endl << "Sorted copy: ";
+    for (const auto& elem : copy) {
+        std::cout << elem << " ";
+    }
+    std::cout << std::endl;
+
+    deque<int> moved = std::move(copy);
+    std::cout << "After move: source size=" << copy.size() << ", target size=" << moved.size()
+              << ", find(8) at " << (std::find(moved.begin(), moved.end(), 8) - moved.begin()) << std::endl;
+}
+
+void test_node_pool() {
+    std::cout << "\n=== Testing Node Pool ===" << std::endl;
+
+    // Nodes returned by shrink_to_fit are kept by the deque's own pool
+    deque<int> dq;
+    for (int i = 0; i < 1000; ++i) {
+        dq.push_back(i);
+    }
+    size_t nodes = dq.node_count();
+    dq.clear();
+    dq.shrink_to_fit();
+    std::cout << "Released " << nodes << " nodes, pool keeps " << dq.pool().free_count()
+              << " (high-water mark " << dq.pool().max_free() << ")" << std::endl;
+    dq.pool().set_max_free(4);
+    std::cout << "Lowered high-water mark to 4: pool keeps " << dq.pool().free_count() << std::endl;
+    for (int i = 0; i < 100; ++i) {
+        dq.push_front(i);
+    }
+    std::cout << "Refilled with 100 elements: pool has " << dq.pool().free_count() << " free nodes left" << std::endl;
+
+    // Short-lived deques recycle nodes through the thread-local pool
+    auto& shared = deque<int>::pool_type::thread_local_pool();
+    shared.reserve(8);
+    size_t before = shared.free_count();
+    for (int round = 0; round < 3; ++round) {
+        deque<int> request(shared);
+        for (int i = 0; i < 200; ++i) {
+            request.push_back(i);
+        }
+        std::cout << "Round " << round << ": shared pool had " << shared.free_count() << " free nodes while in use" << std::endl;
+    }
+    std::cout << "Shared pool free nodes before: " << before << ", after: " << shared.free_count() << std::endl;
+}
+
+int main() {
+    try {
+        std::cout << "Testing deque with C++23 modules!" << std::endl;
+
+        test_basic_operations();
+        test_reference_stability();
+        test_node_reuse();
+        test_copy_and_algorithms();
+        test_node_pool();
+
+        std::cout << "\n=== All tests completed successfully! ===" << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,120 @@
+#include <iostream>
+#include <csignal>
+#include <stdexcept>
+#include <cstdlib>
+#include <sys/wait.h>
+#include <unistd.h>
+
+import cvector;
+
+using namespace containers;
+
+// Death tests for hardened mode: each check runs in a forked child, which must be killed by SIGABRT
+// built against a copy of the module compiled with CVECTOR_HARDENED (target cvector_hardened_test)
+
+static_assert(cvector_hardened, "test_hardened.cpp must be built with CVECTOR_HARDENED");
+
+// keeps the compiler from discarding the checked accesses
+volatile int sink;
+
+// run check in a child process and report whether the child aborted
+template <typename Check>
+bool aborts(Check check) {
+    std::cout.flush();
+    pid_t pid = fork();
+    if (pid < 0) {
+        throw std::runtime_error("fork failed");
+    }
+    if (pid == 0) {
+        check();
+        std::_Exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT;
+}
+
+int failures = 0;
+
+void expect(const char* name, bool aborted, bool should_abort) {
+    std::cout << name << ": " << (aborted ? "aborted" : "exited normally") << std::endl;
+    if (aborted != should_abort) {
+        std::cout << "ERROR: expected " << (should_abort ? "an abort" : "a normal exit") << std::endl;
+        ++failures;
+    }
+}
+
+void test_iterator_invalidation() {
+    std::cout << "=== Testing Iterators After Reallocation ===" << std::endl;
+
+    expect("Iterator used before reallocation", aborts([] {
+        cvector<int> vec;
+        vec.reserve(4);
+        vec.push_back(1);
+        auto it = vec.begin();
+        vec.push_back(2);
+        sink = *it;
+    }), false);
+
+    expect("Iterator dereferenced after reallocation", aborts([] {
+        cvector<int> vec;
+        vec.push_back(1);
+        auto it = vec.begin();
+        for (int i = 0; i < 100; ++i) {
+            vec.push_back(i);
+        }
+        sink = *it;
+    }), true);
+
+    expect("Iterator dereferenced after shrink_to_fit", aborts([] {
+        cvector<int> vec(64);
+        while (vec.size() > 2) {
+            vec.pop_back();
+        }
+        auto it = vec.begin();
+        vec.shrink_to_fit();
+        sink = *it;
+    }), true);
+}
+
+void test_empty_access() {
+    std::cout << "\n=== Testing Empty and Out-of-Range Access ===" << std::endl;
+
+    expect("front() on an empty vector", aborts([] {
+        cvector<int> vec;
+        sink = vec.front();
+    }), true);
+
+    expect("back() on a vector emptied by pop_front", aborts([] {
+        cvector<int> vec;
+        vec.push_back(1);
+        vec.pop_front();
+        sink = vec.back();
+    }), true);
+
+    expect("operator[] one past the end", aborts([] {
+        cvector<int> vec(3);
+        sink = vec[3];
+    }), true);
+}
+
+int main() {
+    try {
+        std::cout << "Testing cvector hardened mode with C++23 modules!" << std::endl;
+
+        test_iterator_invalidation();
+        test_empty_access();
+
+        if (failures > 0) {
+            std::cout << "\n=== " << failures << " hardening checks failed ===" << std::endl;
+            return 1;
+        }
+        std::cout << "\n=== All tests completed successfully! ===" << std::endl;
+
+    } catch (const std::exception& e) {
+        std::cout << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}